@@ -15,17 +15,153 @@
 */
 
 #include "Notification.h"
+#include "utils/logger.h"
 #include <notifications/notification_defines.h>
 #include <notifications/notifications.h>
 
-void ShowNotification(const char* notification) {
+#include <coreinit/mutex.h>
+#include <coreinit/thread.h>
+#include <coreinit/time.h>
+
+#include <cstdio>
+#include <cstring>
+
+// a couple of warnings and a toast is all we ever show at once
+#define NOTIFICATION_QUEUE_SIZE 4
+#define NOTIFICATION_MAX_LENGTH 256
+// the same text won't be shown twice within this long - title switches can repeat a warning every few seconds
+#define NOTIFICATION_COOLDOWN_S 300
+#define NOTIFICATION_RECENT_SIZE 8
+#define NOTIFICATION_FLUSH_POLL_MS 5
+
+struct recent_notification {
+    uint32_t hash;
+    OSTime shown;
+};
+
+static char queue[NOTIFICATION_QUEUE_SIZE][NOTIFICATION_MAX_LENGTH];
+static uint32_t queue_count = 0;
+static recent_notification recent[NOTIFICATION_RECENT_SIZE];
+static uint32_t recent_next = 0;
+
+static OSMutex queue_mutex;
+static bool queue_mutex_ready = false;
+
+alignas(16) static uint8_t sender_stack[0x2000];
+alignas(8) static OSThread sender;
+// all under queue_mutex
+static bool sender_running = false;
+static bool sender_joinable = false;
+
+static bool defaults_set = false;
+
+static uint32_t hash_string(const char *str) {
+    uint32_t hash = 2166136261u;
+    for (; *str; str++) {
+        hash = (hash ^ (uint8_t) *str) * 16777619u;
+    }
+    return hash;
+}
+
+static bool set_defaults() {
+    if (defaults_set) return true;
+
     auto err1 = NotificationModule_SetDefaultValue(NOTIFICATION_MODULE_NOTIFICATION_TYPE_INFO,
                                                    NOTIFICATION_MODULE_DEFAULT_OPTION_KEEP_UNTIL_SHOWN, true);
     auto err2 = NotificationModule_SetDefaultValue(NOTIFICATION_MODULE_NOTIFICATION_TYPE_INFO,
                                                    NOTIFICATION_MODULE_DEFAULT_OPTION_DURATION_BEFORE_FADE_OUT,
                                                    15.0f);
 
-    if (err1 != NOTIFICATION_MODULE_RESULT_SUCCESS || err2 != NOTIFICATION_MODULE_RESULT_SUCCESS) return;
+    defaults_set = err1 == NOTIFICATION_MODULE_RESULT_SUCCESS && err2 == NOTIFICATION_MODULE_RESULT_SUCCESS;
+    return defaults_set;
+}
+
+static int sender_main(int argc, const char **argv) {
+    char notification[NOTIFICATION_MAX_LENGTH];
+    while (true) {
+        OSLockMutex(&queue_mutex);
+        if (queue_count == 0) {
+            sender_running = false;
+            OSUnlockMutex(&queue_mutex);
+            return 0;
+        }
+        memcpy(notification, queue[0], sizeof(notification));
+        memmove(queue[0], queue[1], (--queue_count) * sizeof(queue[0]));
+        OSUnlockMutex(&queue_mutex);
+
+        if (set_defaults()) {
+            NotificationModule_AddInfoNotification(notification);
+        }
+    }
+}
+
+// true if notification was shown (or queued) recently enough to skip. call with queue_mutex held
+static bool recently_shown(const char *notification) {
+    const auto hash = hash_string(notification);
+    const auto now = OSGetTime();
+    // OSTime is signed, the tick macros aren't
+    const auto cooldown = (OSTime) OSSecondsToTicks(NOTIFICATION_COOLDOWN_S);
+    for (auto &entry: recent) {
+        if (entry.shown && entry.hash == hash && now - entry.shown < cooldown) {
+            return true;
+        }
+    }
+
+    recent[recent_next] = {hash, now};
+    recent_next = (recent_next + 1) % NOTIFICATION_RECENT_SIZE;
+    return false;
+}
+
+void ShowNotification(const char* notification) {
+    if (!queue_mutex_ready) {
+        OSInitMutex(&queue_mutex);
+        queue_mutex_ready = true;
+    }
+
+    OSLockMutex(&queue_mutex);
+    if (queue_count == NOTIFICATION_QUEUE_SIZE || recently_shown(notification)) {
+        DEBUG_FUNCTION_LINE_VERBOSE("Dropping notification \"%s\"", notification);
+        OSUnlockMutex(&queue_mutex);
+        return;
+    }
+    snprintf(queue[queue_count++], NOTIFICATION_MAX_LENGTH, "%s", notification);
+
+    if (sender_running) {
+        OSUnlockMutex(&queue_mutex);
+        return;
+    }
+    sender_running = true;
+
+    // the last sender let go of the queue for good when it cleared sender_running, so it can be reaped under the lock
+    if (sender_joinable) OSJoinThread(&sender, nullptr);
+    sender_joinable = OSCreateThread(&sender, sender_main, 0, nullptr, sender_stack + sizeof(sender_stack),
+                                     sizeof(sender_stack), 24, OS_THREAD_ATTRIB_AFFINITY_ANY);
+    const bool started = sender_joinable;
+    if (started) {
+        OSSetThreadName(&sender, "Inkay notifications");
+        OSResumeThread(&sender);
+    }
+    OSUnlockMutex(&queue_mutex);
+
+    if (!started) {
+        // better late than never - send it from here
+        sender_main(0, nullptr);
+    }
+}
+
+void FlushNotifications() {
+    if (!queue_mutex_ready) return;
 
-    NotificationModule_AddInfoNotification(notification);
+    OSLockMutex(&queue_mutex);
+    // the sender holds the lock while it takes from the queue, so it has to be waited for with the lock dropped
+    while (sender_running) {
+        OSUnlockMutex(&queue_mutex);
+        OSSleepTicks(OSMillisecondsToTicks(NOTIFICATION_FLUSH_POLL_MS));
+        OSLockMutex(&queue_mutex);
+    }
+    if (sender_joinable) {
+        OSJoinThread(&sender, nullptr);
+        sender_joinable = false;
+    }
+    OSUnlockMutex(&queue_mutex);
 }
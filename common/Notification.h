@@ -1,3 +1,7 @@
 #pragma once
 
+// queued and sent from a background thread; the same text is only shown once every few minutes
 void ShowNotification(const char* notification);
+// waits for everything queued to be sent and reaps the sender thread - call at application end and before
+// NotificationModule_DeInitLibrary
+void FlushNotifications();
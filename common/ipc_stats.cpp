@@ -0,0 +1,84 @@
+/*  Copyright 2026 Pretendo Network contributors <pretendo.network>
+
+    Permission to use, copy, modify, and/or distribute this software for any purpose with or without fee is hereby
+    granted, provided that the above copyright notice and this permission notice appear in all copies.
+
+    THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES WITH REGARD TO THIS SOFTWARE INCLUDING ALL
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT,
+    INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER
+    IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR
+    PERFORMANCE OF THIS SOFTWARE.
+*/
+
+
+#include "ipc_stats.h"
+#include "utils/logger.h"
+
+#include <iterator>
+
+struct ipc_phase_counts {
+    uint32_t calls[IPC_CATEGORY_COUNT];
+    uint64_t ticks[IPC_CATEGORY_COUNT];
+};
+
+static const char *const category_names[] = {
+        "IOSU kernel",
+        "MCP",
+        "UserConfig",
+        "FunctionPatcher",
+};
+static_assert(std::size(category_names) == IPC_CATEGORY_COUNT);
+
+static const char *const phase_names[] = {
+        "initialize",
+        "title switch",
+};
+static_assert(std::size(phase_names) == IPC_PHASE_COUNT);
+
+// boot and title switches run on one thread, so no need for atomics
+static ipc_phase_counts phases[IPC_PHASE_COUNT];
+static ipc_phase open_phases[IPC_PHASE_COUNT];
+static uint32_t open_count = 0;
+
+void ipc_phase_begin(ipc_phase phase) {
+    if (open_count == IPC_PHASE_COUNT) return;
+
+    phases[phase] = {};
+    open_phases[open_count++] = phase;
+}
+
+void ipc_phase_end(ipc_phase phase, const ipc_budget &budget) {
+    if (open_count == 0 || open_phases[open_count - 1] != phase) {
+        DEBUG_FUNCTION_LINE("Inkay: %s phase closed out of order", phase_names[phase]);
+        return;
+    }
+    open_count--;
+
+    const auto totals = ipc_phase_totals(phase);
+    for (int i = 0; i < IPC_CATEGORY_COUNT; i++) {
+        if (totals.calls[i] > budget[i]) {
+            DEBUG_FUNCTION_LINE("Inkay: %s made %u %s calls, over its budget of %u!", phase_names[phase],
+                                totals.calls[i], category_names[i], budget[i]);
+        } else if (totals.calls[i]) {
+            DEBUG_FUNCTION_LINE_VERBOSE("Inkay: %s: %u %s calls, %u us", phase_names[phase], totals.calls[i],
+                                        category_names[i], totals.microseconds[i]);
+        }
+    }
+}
+
+ipc_totals ipc_phase_totals(ipc_phase phase) {
+    ipc_totals totals{};
+    for (int i = 0; i < IPC_CATEGORY_COUNT; i++) {
+        totals.calls[i] = phases[phase].calls[i];
+        totals.microseconds[i] = (uint32_t) OSTicksToMicroseconds(phases[phase].ticks[i]);
+    }
+    return totals;
+}
+
+void ipc_record(ipc_category category, OSTick ticks) {
+    if (open_count == 0) return;
+
+    auto &counts = phases[open_phases[open_count - 1]];
+    counts.calls[category]++;
+    counts.ticks[category] += ticks;
+}
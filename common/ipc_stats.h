@@ -0,0 +1,69 @@
+/*  Copyright 2026 Pretendo Network contributors <pretendo.network>
+
+    Permission to use, copy, modify, and/or distribute this software for any purpose with or without fee is hereby
+    granted, provided that the above copyright notice and this permission notice appear in all copies.
+
+    THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES WITH REGARD TO THIS SOFTWARE INCLUDING ALL
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT,
+    INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER
+    IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR
+    PERFORMANCE OF THIS SOFTWARE.
+*/
+
+
+#pragma once
+
+#include <coreinit/time.h>
+
+#include <cstdint>
+
+/**
+ * Counts and times the IPC round trips (and other slow cross-module calls) that boot and title switches are made of.
+ * Calls are only recorded while a phase is open, and only against the innermost one - the plugin initializes us in the
+ * middle of a title switch, and that shouldn't count against the title switch's budget.
+ *
+ *   const auto handle = IPC_CALL(IPC_MCP, MCP_Open());
+ */
+enum ipc_category : uint8_t {
+    IPC_IOSU_KERNEL,      ///< Mocha_IOSUKernelRead32/Write32
+    IPC_MCP,              ///< MCP_Open/Close and queries
+    IPC_USERCONFIG,       ///< UCOpen/Close and UCReadSysConfig
+    IPC_FUNCTION_PATCHER, ///< FunctionPatcher_InitLibrary/AddFunctionPatch
+
+    IPC_CATEGORY_COUNT
+};
+
+enum ipc_phase : uint8_t {
+    IPC_PHASE_INITIALIZE,   ///< Inkay_Initialize
+    IPC_PHASE_TITLE_SWITCH, ///< WUMS_APPLICATION_STARTS to the end of WUMS_ALL_APPLICATION_STARTS_DONE
+
+    IPC_PHASE_COUNT
+};
+
+struct ipc_totals {
+    uint32_t calls[IPC_CATEGORY_COUNT];
+    uint32_t microseconds[IPC_CATEGORY_COUNT];
+};
+
+// most calls each category may make in one phase
+using ipc_budget = uint32_t[IPC_CATEGORY_COUNT];
+
+void ipc_phase_begin(ipc_phase phase);
+// closes the innermost phase, which has to be phase. logs the phase's totals, and complains about anything over budget
+void ipc_phase_end(ipc_phase phase, const ipc_budget &budget);
+// totals of the last (or still open) run of phase
+ipc_totals ipc_phase_totals(ipc_phase phase);
+
+void ipc_record(ipc_category category, OSTick ticks);
+
+class ipc_scope {
+public:
+    explicit ipc_scope(ipc_category category) : category(category), start(OSGetSystemTick()) {}
+    ~ipc_scope() { ipc_record(category, OSGetSystemTick() - start); }
+
+private:
+    ipc_category category;
+    OSTick start;
+};
+
+#define IPC_CALL(category, call) ([&] { ipc_scope ipc_scope_(category); return call; }())
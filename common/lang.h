@@ -22,6 +22,7 @@ enum inkay_language {
     EnUwU,
 };
 
+// everything in a .lang file
 struct config_strings {
     const char *plugin_name;
     std::string_view network_category;
@@ -37,6 +38,32 @@ struct config_strings {
     std::string_view multiplayer_port_display;
     std::string_view module_not_found;
     std::string_view module_init_not_found;
+    std::string_view restart_title_notification;
 };
 
-config_strings get_config_strings(inkay_language language);
+// The module and the plugin each get a table of just the strings they show, built at compile time from the .lang files
+// (see lang_tables.h), so getting one is just an index. Each is only defined in the binary that uses it.
+
+// the module's startup notification
+struct module_strings {
+    std::string_view using_nintendo_network;
+    std::string_view using_pretendo_network;
+};
+const module_strings &get_module_strings(inkay_language language);
+
+// the plugin's config menu and module errors
+struct plugin_strings {
+    std::string_view network_category;
+    std::string_view connect_to_network_setting;
+    std::string_view show_startup_toast_setting;
+    std::string_view other_category;
+    std::string_view reset_wwp_setting;
+    std::string_view press_a_action;
+    std::string_view restart_to_apply_action;
+    std::string_view need_menu_action;
+    std::string_view multiplayer_port_display;
+    std::string_view module_not_found;
+    std::string_view module_init_not_found;
+    std::string_view restart_title_notification;
+};
+const plugin_strings &get_plugin_strings(inkay_language language);
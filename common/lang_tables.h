@@ -0,0 +1,99 @@
+/*  Copyright 2026 Pretendo Network contributors <pretendo.network>
+
+    Permission to use, copy, modify, and/or distribute this software for any purpose with or without fee is hereby
+    granted, provided that the above copyright notice and this permission notice appear in all copies.
+
+    THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES WITH REGARD TO THIS SOFTWARE INCLUDING ALL
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT,
+    INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER
+    IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR
+    PERFORMANCE OF THIS SOFTWARE.
+*/
+
+
+#pragma once
+
+#include "lang.h"
+
+#include <array>
+#include <iterator>
+
+/**
+ * Every .lang file, for the module's and the plugin's string tables to pick their strings out of at compile time.
+ * Only include this from those - nothing here is emitted unless it's used, so each binary ends up with its own
+ * strings and not the other's.
+ */
+static constexpr config_strings ja_jp = {
+#include "ja_JP.lang"
+};
+static constexpr config_strings en_us = {
+#include "en_US.lang"
+};
+static constexpr config_strings fr_fr = {
+#include "fr_FR.lang"
+};
+static constexpr config_strings de_de = {
+#include "de_DE.lang"
+};
+static constexpr config_strings it_it = {
+#include "it_IT.lang"
+};
+static constexpr config_strings es_es = {
+#include "es_ES.lang"
+};
+static constexpr config_strings zh_cn = {
+#include "zh_CN.lang"
+};
+static constexpr config_strings ko_kr = {
+#include "ko_KR.lang"
+};
+static constexpr config_strings nl_nl = {
+#include "nl_NL.lang"
+};
+static constexpr config_strings pt_br = {
+#include "pt_BR.lang"
+};
+static constexpr config_strings ru_ru = {
+#include "ru_RU.lang"
+};
+static constexpr config_strings zh_hant = {
+#include "zh_Hant.lang"
+};
+static constexpr config_strings en_uwu = {
+#include "en@uwu.lang"
+};
+
+// indexed by inkay_language - Invalid and System are resolved before we get here, but fall back to English anyway
+static constexpr const config_strings *lang_tables[] = {
+        &ja_jp,   // Japanese
+        &en_us,   // English
+        &fr_fr,   // French
+        &de_de,   // German
+        &it_it,   // Italian
+        &es_es,   // Spanish
+        &zh_cn,   // SimplifiedChinese
+        &ko_kr,   // Korean
+        &nl_nl,   // Dutch
+        &pt_br,   // Portuguese
+        &ru_ru,   // Russian
+        &zh_hant, // TraditionalChinese
+        &en_us,   // Invalid
+        &en_us,   // System
+        &en_uwu,  // EnUwU
+};
+static_assert(std::size(lang_tables) == inkay_language::EnUwU + 1);
+
+// anything a .lang file doesn't have yet is shown in English
+constexpr std::string_view translated(std::string_view string, std::string_view english) {
+    return string.empty() ? english : string;
+}
+
+// one T per language, made by pick from that language's table and the English one
+template <typename T>
+consteval auto pick_strings(T (*pick)(const config_strings &, const config_strings &)) {
+    std::array<T, std::size(lang_tables)> out{};
+    for (size_t i = 0; i < std::size(lang_tables); i++) {
+        out[i] = pick(*lang_tables[i], en_us);
+    }
+    return out;
+}
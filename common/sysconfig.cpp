@@ -18,23 +18,29 @@
 */
 
 #include "sysconfig.h"
+#include "ipc_stats.h"
 #include "utils/logger.h"
 #include "utils/scope_exit.h"
 
 #include <coreinit/mcp.h>
 #include <coreinit/userconfig.h>
-#include <optional>
+#include <cstdio>
+
+// what we know so far - filled in from UC and MCP as it's asked for, or all at once by set_system_info
+static system_info info{};
+static bool have_language = false;
+static bool have_config = false;
+static bool have_os_version = false;
 
 nn::swkbd::LanguageType get_system_language() {
-    static std::optional <nn::swkbd::LanguageType> cached_language{};
-    if (cached_language) return *cached_language;
+    if (have_language) return (nn::swkbd::LanguageType) info.language;
 
-    UCHandle handle = UCOpen();
+    UCHandle handle = IPC_CALL(IPC_USERCONFIG, UCOpen());
     if (handle < 0) {
         DEBUG_FUNCTION_LINE("Error opening UC: %d", handle);
         return nn::swkbd::LanguageType::English;
     }
-    scope_exit uc_c([&] { UCClose(handle); });
+    scope_exit uc_c([&] { IPC_CALL(IPC_USERCONFIG, UCClose(handle)); });
 
     nn::swkbd::LanguageType language;
 
@@ -47,37 +53,39 @@ nn::swkbd::LanguageType get_system_language() {
             .data = &language,
     };
 
-    UCError err = UCReadSysConfig(handle, 1, &settings);
+    UCError err = IPC_CALL(IPC_USERCONFIG, UCReadSysConfig(handle, 1, &settings));
     if (err != UC_ERROR_OK) {
         DEBUG_FUNCTION_LINE("Error reading UC: %d!", err);
         return nn::swkbd::LanguageType::English;
     }
 
     DEBUG_FUNCTION_LINE_VERBOSE("System language found: %d", language);
-    cached_language = language;
+    info.language = (uint32_t) language;
+    have_language = true;
     return language;
 }
 
-static std::optional<MCPSysProdSettings> mcp_config;
-static std::optional<MCPSystemVersion> mcp_os_version;
 static void get_mcp_config() {
-    int mcp = MCP_Open();
-    scope_exit mcp_c([&] { MCP_Close(mcp); });
+    int mcp = IPC_CALL(IPC_MCP, MCP_Open());
+    scope_exit mcp_c([&] { IPC_CALL(IPC_MCP, MCP_Close(mcp)); });
 
     alignas(0x40) MCPSysProdSettings config {};
-    if (MCP_GetSysProdSettings(mcp, &config)) {
+    if (IPC_CALL(IPC_MCP, MCP_GetSysProdSettings(mcp, &config))) {
         DEBUG_FUNCTION_LINE("Could not get MCP system config!");
         return;
     }
-    mcp_config = config;
+    snprintf(info.serial, sizeof(info.serial), "%s", config.serial_id);
+    info.region = config.product_area;
+    have_config = true;
 
     //get os version
     MCPSystemVersion os_version;
-    if (MCP_GetSystemVersion(mcp, &os_version)) {
+    if (IPC_CALL(IPC_MCP, MCP_GetSystemVersion(mcp, &os_version))) {
         DEBUG_FUNCTION_LINE("Could not get MCP system config!");
         return;
     }
-    mcp_os_version = os_version;
+    info.os_version = os_version;
+    have_os_version = true;
 
     DEBUG_FUNCTION_LINE_VERBOSE("Running on %d.%d.%d%c; %s%s",
                                 os_version.major, os_version.minor, os_version.patch, os_version.region
@@ -86,15 +94,30 @@ static void get_mcp_config() {
 }
 
 const char * get_console_serial() {
-    if (!mcp_config) get_mcp_config();
+    if (!have_config) get_mcp_config();
 
-    return mcp_config ? mcp_config->serial_id : "123456789";
+    return have_config ? info.serial : "123456789";
 }
 
 MCPSystemVersion get_console_os_version() {
-    if (!mcp_os_version) get_mcp_config();
+    if (!have_os_version) get_mcp_config();
+
+    return have_os_version ? info.os_version : (MCPSystemVersion) { .major = 5, .minor = 5, .patch = 5, .region = 'E' };
+}
+
+system_info get_system_info() {
+    system_info snapshot{};
+    snapshot.language = (uint32_t) get_system_language();
+    snprintf(snapshot.serial, sizeof(snapshot.serial), "%s", get_console_serial());
+    snapshot.region = info.region;
+    snapshot.os_version = get_console_os_version();
+    snapshot.peertopeer_port = get_console_peertopeer_port();
+    return snapshot;
+}
 
-    return mcp_os_version.value_or((MCPSystemVersion) { .major = 5, .minor = 5, .patch = 5, .region = 'E' });
+void set_system_info(const system_info &snapshot) {
+    info = snapshot;
+    have_language = have_config = have_os_version = true;
 }
 
 static inline int digit(char a) {
@@ -8,9 +8,25 @@
 #include <nn/swkbd.h>
 #include <coreinit/mcp.h>
 
+#include <cstdint>
+
+// everything we want to know about the console, so the module can ask once and hand it to the plugin
+struct system_info {
+    uint32_t language; ///< nn::swkbd::LanguageType
+    char serial[12];
+    uint32_t region;   ///< MCPRegion
+    MCPSystemVersion os_version;
+    uint16_t peertopeer_port;
+};
+
 nn::swkbd::LanguageType get_system_language();
 const char * get_console_serial();
 MCPSystemVersion get_console_os_version();
 unsigned short get_console_peertopeer_port();
 
+// gathers everything above, asking UC/MCP for whatever isn't known yet
+system_info get_system_info();
+// takes a snapshot from get_system_info (in the module), so none of the above needs to ask UC/MCP again
+void set_system_info(const system_info &snapshot);
+
 #endif //INKAY_SYSCONFIG_H
@@ -16,11 +16,14 @@
 */
 
 #include "config.h"
+#include "module.h"
 
 #include "wut_extra.h"
 #include "utils/logger.h"
+#include "utils/job_runner.h"
 #include "sysconfig.h"
 #include "lang.h"
+#include "Notification.h"
 
 #include <wups.h>
 #include <wups/storage.h>
@@ -37,15 +40,17 @@
 
 #include <format>
 
-static config_strings strings;
+static const plugin_strings *strings;
 
 bool Config::connect_to_network = true;
 bool Config::show_startup_toast = true;
 bool Config::need_relaunch = false;
+bool Config::network_changed = false;
 bool Config::unregister_task_item_pressed = false;
 bool Config::is_wiiu_menu = false;
 uint32_t Config::language = 13;
 inkay_language Config::current_language = English;
+uint32_t Config::dirty = 0;
 
 static WUPSConfigAPICallbackStatus report_error(WUPSConfigAPIStatus err) {
     DEBUG_FUNCTION_LINE_VERBOSE("WUPS config error: %s", WUPSConfigAPI_GetStatusStr(err));
@@ -59,13 +64,10 @@ static void report_storage_error(WUPSStorageError err) {
 static void connect_to_network_changed(ConfigItemBoolean* item, bool new_value) {
     DEBUG_FUNCTION_LINE_VERBOSE("connect_to_network changed to: %d", new_value);
     if (new_value != Config::connect_to_network) {
-        Config::need_relaunch = true;
+        Config::network_changed = true;
+        Config::dirty |= Config::DIRTY_CONNECT_TO_NETWORK;
     }
     Config::connect_to_network = new_value;
-
-    WUPSStorageError res;
-    res = WUPSStorageAPI::Store<bool>("connect_to_network", Config::connect_to_network);
-    if (res != WUPS_STORAGE_ERROR_SUCCESS) return report_storage_error(res);
 }
 
 static void language_changed(ConfigItemMultipleValues* item, uint32_t new_value) {
@@ -75,51 +77,57 @@ static void language_changed(ConfigItemMultipleValues* item, uint32_t new_value)
             Config::current_language = (inkay_language)get_system_language();
         else
             Config::current_language = (inkay_language)new_value;
+        Config::dirty |= Config::DIRTY_LANGUAGE;
     }
     Config::language = new_value;
-
-    WUPSStorageError res;
-    res = WUPSStorageAPI::Store<int>("language", Config::language);
-    if (res != WUPS_STORAGE_ERROR_SUCCESS) return report_storage_error(res);
 }
 
 static void show_startup_toast_changed(ConfigItemBoolean* item, bool new_value) {
     DEBUG_FUNCTION_LINE_VERBOSE("show_startup_toast changed to: %d", new_value);
+    if (new_value != Config::show_startup_toast) {
+        Config::dirty |= Config::DIRTY_SHOW_STARTUP_TOAST;
+    }
     Config::show_startup_toast = new_value;
+}
 
-    WUPSStorageError res;
-    res = WUPSStorageAPI::Store<bool>("show_startup_toast", Config::show_startup_toast);
-    if (res != WUPS_STORAGE_ERROR_SUCCESS) return report_storage_error(res);
+static bool unregister_oltopic_tasks(void *context) {
+    nn::act::Initialize();
+    Initialize__Q2_2nn4bossFv();
+
+    const uint8_t num_accounts = nn::act::GetNumOfAccounts();
+    for (uint8_t i = 1; i <= num_accounts; i++)
+    {
+        job_set_progress(i - 1, num_accounts);
+        if (nn::act::IsSlotOccupied(i) && nn::act::IsNetworkAccountEx(i))
+        {
+          nn::boss::Task task{};
+          nn::act::PersistentId persistentId = nn::act::GetPersistentIdEx(i);
+
+          __ct__Q3_2nn4boss4TaskFv(&task);
+          Initialize__Q3_2nn4boss4TaskFPCcUi(&task, "oltopic", persistentId);
+
+  // bypasses compiler warning about unused variable
+  #ifdef DEBUG
+          uint32_t res = Unregister__Q3_2nn4boss4TaskFv(&task);
+          DEBUG_FUNCTION_LINE_VERBOSE("Unregistered oltopic for: SlotNo %d | Persistent ID %08x -> 0x%08x", i, persistentId, res);
+  #else
+          Unregister__Q3_2nn4boss4TaskFv(&task);
+  #endif
+        }
+    }
+    job_set_progress(num_accounts, num_accounts);
+
+    Finalize__Q2_2nn4bossFv();
+    nn::act::Finalize();
+    return true;
 }
 
 static void unregister_task_item_on_input_cb(void *context, WUPSConfigSimplePadData input) {
     if (!Config::unregister_task_item_pressed && Config::is_wiiu_menu && ((input.buttons_d & WUPS_CONFIG_BUTTON_A) == WUPS_CONFIG_BUTTON_A)) {
-
-        nn::act::Initialize();
-        Initialize__Q2_2nn4bossFv();
-
-        for (uint8_t i = 1; i <= nn::act::GetNumOfAccounts(); i++)
-        {
-            if (nn::act::IsSlotOccupied(i) && nn::act::IsNetworkAccountEx(i))
-            {
-              nn::boss::Task task{};
-              nn::act::PersistentId persistentId = nn::act::GetPersistentIdEx(i);
-
-              __ct__Q3_2nn4boss4TaskFv(&task);
-              Initialize__Q3_2nn4boss4TaskFPCcUi(&task, "oltopic", persistentId);
-
-      // bypasses compiler warning about unused variable
-      #ifdef DEBUG
-              uint32_t res = Unregister__Q3_2nn4boss4TaskFv(&task);
-              DEBUG_FUNCTION_LINE_VERBOSE("Unregistered oltopic for: SlotNo %d | Persistent ID %08x -> 0x%08x", i, persistentId, res);
-      #else
-              Unregister__Q3_2nn4boss4TaskFv(&task);
-      #endif
-          }
-      }
-
-        Finalize__Q2_2nn4bossFv();
-        nn::act::Finalize();
+        // talking to BOSS for every account takes a while, so keep it off the menu's thread
+        if (!job_start("Inkay oltopic unregister", unregister_oltopic_tasks, nullptr)) {
+            return;
+        }
 
         Config::unregister_task_item_pressed = !Config::unregister_task_item_pressed;
         Config::need_relaunch = true;
@@ -127,12 +135,16 @@ static void unregister_task_item_on_input_cb(void *context, WUPSConfigSimplePadD
 }
 
 static int32_t unregister_task_item_get_display_value(void *context, char *out_buf, int32_t out_size) {
-    auto string = strings.need_menu_action;
+    auto string = strings->need_menu_action;
     if (Config::is_wiiu_menu) {
-        if (Config::unregister_task_item_pressed) {
-            string = strings.restart_to_apply_action;
+        if (Config::unregister_task_item_pressed && job_status() == job_state::Running) {
+            const auto progress = job_progress();
+            snprintf(out_buf, out_size, "%u/%u", progress.done, progress.total);
+            return 0;
+        } else if (Config::unregister_task_item_pressed) {
+            string = strings->restart_to_apply_action;
         } else {
-            string = strings.press_a_action;
+            string = strings->press_a_action;
         }
     }
 
@@ -152,16 +164,16 @@ static WUPSConfigAPICallbackStatus ConfigMenuOpenedCallback(WUPSConfigCategoryHa
     Config::is_wiiu_menu = (current_title_id == wiiu_menu_tid);
 
     // get translation strings
-    strings = get_config_strings(Config::current_language);
+    strings = &get_plugin_strings(Config::current_language);
 
     // create root config category
     WUPSConfigCategory root = WUPSConfigCategory(rootHandle);
 
-    auto network_cat = WUPSConfigCategory::Create(strings.network_category, err);
+    auto network_cat = WUPSConfigCategory::Create(strings->network_category, err);
     if (!network_cat) return report_error(err);
 
     //                                                  config id                   display name            default        current value             changed callback
-    auto connect_item = WUPSConfigItemBoolean::Create("connect_to_network", strings.connect_to_network_setting, true, Config::connect_to_network, &connect_to_network_changed, err);
+    auto connect_item = WUPSConfigItemBoolean::Create("connect_to_network", strings->connect_to_network_setting, true, Config::connect_to_network, &connect_to_network_changed, err);
     if (!connect_item) return report_error(err);
 
     res = network_cat->add(std::move(*connect_item), err);
@@ -170,7 +182,7 @@ static WUPSConfigAPICallbackStatus ConfigMenuOpenedCallback(WUPSConfigCategoryHa
     {
         uint16_t port = get_console_peertopeer_port();
         char buffer[256];
-        snprintf(buffer, sizeof(buffer), strings.multiplayer_port_display.data(), port);
+        snprintf(buffer, sizeof(buffer), strings->multiplayer_port_display.data(), port);
         auto multiplayer_port_display = WUPSConfigItemStub::Create(buffer, err);
         if (!multiplayer_port_display) return report_error(err);
 
@@ -181,10 +193,10 @@ static WUPSConfigAPICallbackStatus ConfigMenuOpenedCallback(WUPSConfigCategoryHa
     res = root.add(std::move(*network_cat), err);
     if (!res) return report_error(err);
 
-    auto other_cat = WUPSConfigCategory::Create(strings.other_category, err);
+    auto other_cat = WUPSConfigCategory::Create(strings->other_category, err);
     if (!other_cat) return report_error(err);
 
-    auto startup_toast_item = WUPSConfigItemBoolean::Create("show_startup_toast", strings.show_startup_toast_setting, true, Config::show_startup_toast, &show_startup_toast_changed, err);
+    auto startup_toast_item = WUPSConfigItemBoolean::Create("show_startup_toast", strings->show_startup_toast_setting, true, Config::show_startup_toast, &show_startup_toast_changed, err);
     if (!startup_toast_item) return report_error(err);
 
     WUPSConfigAPIItemCallbacksV2 unregisterTasksItemCallbacks = {
@@ -200,7 +212,7 @@ static WUPSConfigAPICallbackStatus ConfigMenuOpenedCallback(WUPSConfigCategoryHa
     };
 
     WUPSConfigAPIItemOptionsV2 unregisterTasksItemOptions = {
-            .displayName = strings.reset_wwp_setting.data(),
+            .displayName = strings->reset_wwp_setting.data(),
             .context = nullptr,
             .callbacks = unregisterTasksItemCallbacks,
     };
@@ -247,9 +259,22 @@ static WUPSConfigAPICallbackStatus ConfigMenuOpenedCallback(WUPSConfigCategoryHa
 
 static void ConfigMenuClosedCallback() {
     // Save all changes
-    WUPSStorageError res;
-    res = WUPSStorageAPI::SaveStorage();
-    if (res != WUPS_STORAGE_ERROR_SUCCESS) return report_storage_error(res);
+    Config::Save();
+    // a menu action might still be going - let it finish before we relaunch out from under it
+    job_wait();
+
+    if (Config::network_changed) {
+        // the module swaps its patches live where it can, and tells us if it couldn't
+        const auto reasons = Inkay_SetNetwork(Config::connect_to_network);
+        DEBUG_FUNCTION_LINE_VERBOSE("Network switch result: %08x", reasons);
+        if (reasons & INKAY_RELAUNCH_UNSUPPORTED) {
+            Config::need_relaunch = true;
+        } else if (reasons & INKAY_RELAUNCH_RUNNING_TITLE) {
+            // everything else has switched - only this title is still on the old network until it's restarted
+            ShowNotification(strings->restart_title_notification.data());
+        }
+        Config::network_changed = false;
+    }
 
     if (Config::need_relaunch) {
         // Need to reload the console so the patches reset
@@ -267,9 +292,8 @@ void Config::Init() {
     cres = WUPSConfigAPI_Init(configOptions, ConfigMenuOpenedCallback, ConfigMenuClosedCallback);
     if (cres != WUPSCONFIG_API_RESULT_SUCCESS) return (void)report_error(cres);
 
-    WUPSStorageError res;
-    // Try to get values from storage
-    res = WUPSStorageAPI::Get<bool>("connect_to_network", Config::connect_to_network);
+    // Try to get values from storage - anything missing keeps its default and gets written on the next save
+    auto res = WUPSStorageAPI::Get<bool>("connect_to_network", Config::connect_to_network);
     if (res == WUPS_STORAGE_ERROR_NOT_FOUND) {
         DEBUG_FUNCTION_LINE("Connect to network value not found, attempting to migrate/create");
 
@@ -279,40 +303,49 @@ void Config::Init() {
             Config::connect_to_network = !skipPatches;
             WUPSStorageAPI::DeleteItem("skipPatches");
         }
-    
-        // Add the value to the storage if it's missing.
-        res = WUPSStorageAPI::Store<bool>("connect_to_network", connect_to_network);
-        if (res != WUPS_STORAGE_ERROR_SUCCESS) return report_storage_error(res);
+        Config::dirty |= DIRTY_CONNECT_TO_NETWORK;
     }
-    else if (res != WUPS_STORAGE_ERROR_SUCCESS) return report_storage_error(res);
+    else if (res != WUPS_STORAGE_ERROR_SUCCESS) report_storage_error(res);
 
     res = WUPSStorageAPI::Get<uint32_t>("language", Config::language);
     if (res == WUPS_STORAGE_ERROR_NOT_FOUND) {
         DEBUG_FUNCTION_LINE("Language value not found, attempting to create");
-
-        // Add the value to the storage.
-        res = WUPSStorageAPI::Store<uint32_t>("language", Config::language);
-        if (res != WUPS_STORAGE_ERROR_SUCCESS) return report_storage_error(res);
+        Config::dirty |= DIRTY_LANGUAGE;
     }
-    else if (res != WUPS_STORAGE_ERROR_SUCCESS) return report_storage_error(res);
-  
+    else if (res != WUPS_STORAGE_ERROR_SUCCESS) report_storage_error(res);
+
     res = WUPSStorageAPI::Get<bool>("show_startup_toast", Config::show_startup_toast);
     if (res == WUPS_STORAGE_ERROR_NOT_FOUND) {
         DEBUG_FUNCTION_LINE("Show startup toast value not found, attempting to create");
-    
-        // Add the value to the storage if it's missing.
-        res = WUPSStorageAPI::Store<bool>("show_startup_toast", show_startup_toast);
-        if (res != WUPS_STORAGE_ERROR_SUCCESS) return report_storage_error(res);
+        Config::dirty |= DIRTY_SHOW_STARTUP_TOAST;
     }
-    else if (res != WUPS_STORAGE_ERROR_SUCCESS) return report_storage_error(res);
+    else if (res != WUPS_STORAGE_ERROR_SUCCESS) report_storage_error(res);
 
     // Set the language that's currently used
     if (Config::language == inkay_language::System)
         Config::current_language = (inkay_language)get_system_language();
     else
         Config::current_language = (inkay_language)Config::language;
+}
+
+void Config::Save() {
+    if (!Config::dirty) return;
+
+    WUPSStorageError res = WUPS_STORAGE_ERROR_SUCCESS;
+    if (Config::dirty & DIRTY_CONNECT_TO_NETWORK) {
+        res = WUPSStorageAPI::Store<bool>("connect_to_network", Config::connect_to_network);
+        if (res != WUPS_STORAGE_ERROR_SUCCESS) return report_storage_error(res);
+    }
+    if (Config::dirty & DIRTY_LANGUAGE) {
+        res = WUPSStorageAPI::Store<uint32_t>("language", Config::language);
+        if (res != WUPS_STORAGE_ERROR_SUCCESS) return report_storage_error(res);
+    }
+    if (Config::dirty & DIRTY_SHOW_STARTUP_TOAST) {
+        res = WUPSStorageAPI::Store<bool>("show_startup_toast", Config::show_startup_toast);
+        if (res != WUPS_STORAGE_ERROR_SUCCESS) return report_storage_error(res);
+    }
 
-    // Save storage
     res = WUPSStorageAPI::SaveStorage();
     if (res != WUPS_STORAGE_ERROR_SUCCESS) return report_storage_error(res);
+    Config::dirty = 0;
 }
@@ -11,6 +11,16 @@
 class Config {
 public:
     static void Init();
+    // writes out whatever changed since the last save - nothing touches the SD card otherwise
+    static void Save();
+
+    // which wups config items need storing
+    enum Dirty : uint32_t {
+        DIRTY_CONNECT_TO_NETWORK = 1 << 0,
+        DIRTY_LANGUAGE = 1 << 1,
+        DIRTY_SHOW_STARTUP_TOAST = 1 << 2,
+    };
+    static uint32_t dirty;
 
     // wups config items
     static bool connect_to_network;
@@ -20,6 +30,7 @@ public:
 
     // private stuff
     static bool need_relaunch;
+    static bool network_changed;
 
     // private stuff
     static bool is_wiiu_menu;
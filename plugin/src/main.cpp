@@ -22,6 +22,8 @@
 #include <utils/logger.h>
 #include "config.h"
 #include "module.h"
+#include "Notification.h"
+#include "utils/job_runner.h"
 
 #define INKAY_VERSION "v3.0.0"
 
@@ -43,6 +45,8 @@ INITIALIZE_PLUGIN() {
     WHBLogCafeInit();
     WHBLogUdpInit();
 
+    // before Config::Init, which wants the system language
+    Inkay_LoadSystemInfo();
     Config::Init();
 
     if (NotificationModule_InitLibrary() != NOTIFICATION_MODULE_RESULT_SUCCESS) {
@@ -54,7 +58,11 @@ INITIALIZE_PLUGIN() {
 }
 
 DEINITIALIZE_PLUGIN() {
+    // anything Config::Init had to create, or the menu changed without closing cleanly
+    Config::Save();
+    job_wait();
     Inkay_Finalize();
+    FlushNotifications();
     NotificationModule_DeInitLibrary();
 
     WHBLogCafeDeinit();
@@ -67,5 +75,6 @@ ON_APPLICATION_START() {
 }
 
 ON_APPLICATION_ENDS() {
-
+    // the sender thread can't outlive the process it was started in
+    FlushNotifications();
 }
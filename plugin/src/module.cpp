@@ -20,6 +20,7 @@
 #include "utils/logger.h"
 #include "config.h"
 #include "lang.h"
+#include "sysconfig.h"
 
 #include <coreinit/dynload.h>
 
@@ -27,13 +28,14 @@ static OSDynLoad_Module module;
 static void (*moduleInitialize)(bool, bool, inkay_language) = nullptr;
 static InkayStatus (*moduleGetStatus)() = nullptr;
 static void (*moduleSetPluginRunning)() = nullptr;
+static uint32_t (*moduleSetNetwork)(bool) = nullptr;
 
 static const char *get_module_not_found_message() {
-    return get_config_strings(Config::current_language).module_not_found.data();
+    return get_plugin_strings(Config::current_language).module_not_found.data();
 }
 
 static const char *get_module_init_not_found_message() {
-    return get_config_strings(Config::current_language).module_init_not_found.data();
+    return get_plugin_strings(Config::current_language).module_init_not_found.data();
 }
 
 void Inkay_Initialize(bool apply_patches, bool show_startup_toast) {
@@ -63,6 +65,7 @@ void Inkay_Finalize() {
         moduleInitialize = nullptr;
         moduleGetStatus = nullptr;
         moduleSetPluginRunning = nullptr;
+        moduleSetNetwork = nullptr;
     }
 }
 
@@ -91,3 +94,39 @@ void Inkay_SetPluginRunning() {
 
     moduleSetPluginRunning();
 }
+
+uint32_t Inkay_SetNetwork(bool pretendo) {
+    if (!module) {
+        return INKAY_RELAUNCH_UNSUPPORTED;
+    }
+
+    // older modules can only switch with a relaunch
+    if (!moduleSetNetwork && OSDynLoad_FindExport(module, OS_DYNLOAD_EXPORT_FUNC, "Inkay_SetNetwork", reinterpret_cast<void * *>(&moduleSetNetwork)) != OS_DYNLOAD_OK) {
+        DEBUG_FUNCTION_LINE("Failed to find \"Inkay_SetNetwork\" function");
+        return INKAY_RELAUNCH_UNSUPPORTED;
+    }
+
+    return moduleSetNetwork(pretendo);
+}
+
+void Inkay_LoadSystemInfo() {
+    // runs before Inkay_Initialize, which is what normally acquires the module
+    OSDynLoad_Module inkay;
+    if (OSDynLoad_Acquire("inkay", &inkay) != OS_DYNLOAD_OK) {
+        return;
+    }
+
+    // older modules don't share it, sysconfig.h will just ask the system itself
+    bool (*moduleGetSystemInfo)(system_info *, uint32_t) = nullptr;
+    if (OSDynLoad_FindExport(inkay, OS_DYNLOAD_EXPORT_FUNC, "Inkay_GetSystemInfo", reinterpret_cast<void * *>(&moduleGetSystemInfo)) != OS_DYNLOAD_OK) {
+        DEBUG_FUNCTION_LINE("Failed to find \"Inkay_GetSystemInfo\" function");
+        OSDynLoad_Release(inkay);
+        return;
+    }
+
+    system_info info;
+    if (moduleGetSystemInfo(&info, sizeof(info))) {
+        set_system_info(info);
+    }
+    OSDynLoad_Release(inkay);
+}
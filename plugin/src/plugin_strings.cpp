@@ -0,0 +1,39 @@
+/*  Copyright 2026 Pretendo Network contributors <pretendo.network>
+
+    Permission to use, copy, modify, and/or distribute this software for any purpose with or without fee is hereby
+    granted, provided that the above copyright notice and this permission notice appear in all copies.
+
+    THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES WITH REGARD TO THIS SOFTWARE INCLUDING ALL
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT,
+    INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER
+    IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR
+    PERFORMANCE OF THIS SOFTWARE.
+*/
+
+
+#include "lang.h"
+#include "lang_tables.h"
+
+static constexpr plugin_strings pick(const config_strings &s, const config_strings &en) {
+    return {
+            .network_category = translated(s.network_category, en.network_category),
+            .connect_to_network_setting = translated(s.connect_to_network_setting, en.connect_to_network_setting),
+            .show_startup_toast_setting = translated(s.show_startup_toast_setting, en.show_startup_toast_setting),
+            .other_category = translated(s.other_category, en.other_category),
+            .reset_wwp_setting = translated(s.reset_wwp_setting, en.reset_wwp_setting),
+            .press_a_action = translated(s.press_a_action, en.press_a_action),
+            .restart_to_apply_action = translated(s.restart_to_apply_action, en.restart_to_apply_action),
+            .need_menu_action = translated(s.need_menu_action, en.need_menu_action),
+            .multiplayer_port_display = translated(s.multiplayer_port_display, en.multiplayer_port_display),
+            .module_not_found = translated(s.module_not_found, en.module_not_found),
+            .module_init_not_found = translated(s.module_init_not_found, en.module_init_not_found),
+            .restart_title_notification = translated(s.restart_title_notification, en.restart_title_notification),
+    };
+}
+
+static constexpr auto plugin_tables = pick_strings<plugin_strings>(pick);
+
+const plugin_strings &get_plugin_strings(inkay_language language) {
+    if ((size_t) language >= plugin_tables.size()) return plugin_tables[inkay_language::English];
+    return plugin_tables[language];
+}
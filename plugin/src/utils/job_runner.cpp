@@ -0,0 +1,79 @@
+/*  Copyright 2026 Pretendo Network contributors <pretendo.network>
+
+    Permission to use, copy, modify, and/or distribute this software for any purpose with or without fee is hereby
+    granted, provided that the above copyright notice and this permission notice appear in all copies.
+
+    THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES WITH REGARD TO THIS SOFTWARE INCLUDING ALL
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT,
+    INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER
+    IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR
+    PERFORMANCE OF THIS SOFTWARE.
+*/
+
+
+#include "job_runner.h"
+#include "logger.h"
+
+#include <coreinit/thread.h>
+
+#include <atomic>
+
+alignas(16) static uint8_t worker_stack[0x4000];
+alignas(8) static OSThread worker;
+// the worker isn't detached, so it has to be joined before the next job (or unload) reuses its stack
+static bool worker_joinable = false;
+
+static std::atomic<job_state> state = job_state::Idle;
+static std::atomic<uint32_t> progress_done = 0;
+static std::atomic<uint32_t> progress_total = 0;
+
+static job_fn current_fn = nullptr;
+static void *current_context = nullptr;
+
+static int worker_main(int argc, const char **argv) {
+    const bool ok = current_fn(current_context);
+    state = ok ? job_state::Done : job_state::Failed;
+    return 0;
+}
+
+bool job_start(const char *name, job_fn fn, void *context) {
+    if (state == job_state::Running) return false;
+    job_wait();
+
+    current_fn = fn;
+    current_context = context;
+    progress_done = 0;
+    progress_total = 0;
+    state = job_state::Running;
+
+    if (!OSCreateThread(&worker, worker_main, 0, nullptr, worker_stack + sizeof(worker_stack), sizeof(worker_stack),
+                        24, OS_THREAD_ATTRIB_AFFINITY_ANY)) {
+        DEBUG_FUNCTION_LINE("Failed to create the worker thread for %s", name);
+        state = job_state::Failed;
+        return false;
+    }
+    worker_joinable = true;
+    OSSetThreadName(&worker, name);
+    OSResumeThread(&worker);
+    return true;
+}
+
+void job_wait() {
+    if (!worker_joinable) return;
+
+    OSJoinThread(&worker, nullptr);
+    worker_joinable = false;
+}
+
+job_state job_status() {
+    return state;
+}
+
+job_progress_t job_progress() {
+    return {progress_done, progress_total};
+}
+
+void job_set_progress(uint32_t done, uint32_t total) {
+    progress_total = total;
+    progress_done = done;
+}
@@ -0,0 +1,45 @@
+/*  Copyright 2026 Pretendo Network contributors <pretendo.network>
+
+    Permission to use, copy, modify, and/or distribute this software for any purpose with or without fee is hereby
+    granted, provided that the above copyright notice and this permission notice appear in all copies.
+
+    THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES WITH REGARD TO THIS SOFTWARE INCLUDING ALL
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT,
+    INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER
+    IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR
+    PERFORMANCE OF THIS SOFTWARE.
+*/
+
+
+#pragma once
+
+#include <cstdint>
+
+/**
+ * Runs one slow config menu action at a time on a worker thread, so the menu keeps rendering. The job reports how far
+ * along it is with job_set_progress, and the menu item polls job_status/job_progress from its display callback.
+ */
+enum class job_state : uint32_t {
+    Idle,    ///< Nothing started yet
+    Running, ///< The worker is busy
+    Done,    ///< The last job finished, successfully
+    Failed,  ///< The last job finished, but returned false (or never started)
+};
+
+struct job_progress_t {
+    uint32_t done;
+    uint32_t total;
+};
+
+using job_fn = bool (*)(void *context);
+
+// false if a job is still running, or the worker couldn't be started
+bool job_start(const char *name, job_fn fn, void *context);
+// blocks until the current job (if any) has finished - needed before relaunching or unloading the plugin
+void job_wait();
+
+job_state job_status();
+job_progress_t job_progress();
+
+// for the job itself
+void job_set_progress(uint32_t done, uint32_t total);
@@ -16,6 +16,8 @@
 
 #pragma once
 
+#include <cstdint>
+
 enum class InkayStatus {
     Uninitialized, ///< The module isn't initialized
     Nintendo,      ///< The module is initialized but hasn't applied any patches
@@ -23,3 +25,10 @@ enum class InkayStatus {
 
     Error = -1     ///< Failed to retrieve the module status
 };
+
+/// What Inkay_SetNetwork couldn't switch live. 0 means the switch is complete.
+enum InkayRelaunchReason : uint32_t {
+    INKAY_RELAUNCH_NONE = 0,
+    INKAY_RELAUNCH_RUNNING_TITLE = 1 << 0, ///< The running title keeps the old network's patches until it exits
+    INKAY_RELAUNCH_UNSUPPORTED = 1 << 1,   ///< The module couldn't switch - relaunch to apply the setting
+};
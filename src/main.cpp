@@ -27,6 +27,7 @@
 
 #include <coreinit/dynload.h>
 #include <coreinit/mcp.h>
+#include <coreinit/memory.h>
 
 #include <notifications/notifications.h>
 #include <utils/logger.h>
@@ -62,32 +63,22 @@ WUMS_USE_WUT_DEVOPTAB();
 #include "patches/account_settings.h"
 #include "patches/dns_hooks.h"
 #include "patches/eshop_applet.h"
+#include "patches/idbe_cache.h"
 #include "patches/olv_applet.h"
-#include "patches/game_peertopeer.h"
+#include "patches/patch_pack.h"
+#include "patches/title_patches.h"
 #include "sysconfig.h"
+#include "ipc_stats.h"
 #include "lang.h"
-
-//thanks @Gary#4139 :p
-static void write_string(uint32_t addr, const char *str) {
-    int len = strlen(str) + 1;
-    int remaining = len % 4;
-    int num = len - remaining;
-
-    for (int i = 0; i < (num / 4); i++) {
-        Mocha_IOSUKernelWrite32(addr + i * 4, *(uint32_t * )(str + i * 4));
-    }
-
-    if (remaining > 0) {
-        uint8_t buf[4];
-        Mocha_IOSUKernelRead32(addr + num, (uint32_t * ) & buf);
-
-        for (int i = 0; i < remaining; i++) {
-            buf[i] = *(str + num + i);
-        }
-
-        Mocha_IOSUKernelWrite32(addr + num, *(uint32_t * ) & buf);
-    }
-}
+#include "utils/hook_registry.h"
+#include "utils/hook_stats.h"
+#include "utils/iosu_journal.h"
+#include "utils/patch_txn.h"
+#include "utils/rpl_info.h"
+#include "utils/sd_file.h"
+#include "utils/title_cache.h"
+#include "utils/title_context.h"
+#include "utils/trace.h"
 
 static bool is555(MCPSystemVersion version) {
     return (version.major == 5) && (version.minor == 5) && (version.patch >= 5);
@@ -97,14 +88,14 @@ static const char *get_nintendo_network_message(inkay_language language) {
     // TL note: "Nintendo Network" is a proper noun - "Network" is part of the name
     // TL note: "Using" instead of "Connected" is deliberate - we don't know if a successful connection exists, we are
     // only specifying what we'll *attempt* to connect to
-    return get_config_strings(language).using_nintendo_network.data();
+    return get_module_strings(language).using_nintendo_network.data();
 }
 
 static const char *get_pretendo_message(inkay_language language) {
     // TL note: "Pretendo Network" is also a proper noun - though "Pretendo" alone can refer to us as a project
     // TL note: "Using" instead of "Connected" is deliberate - we don't know if a successful connection exists, we are
     // only specifying what we'll *attempt* to connect to
-    return get_config_strings(language).using_pretendo_network.data();
+    return get_module_strings(language).using_pretendo_network.data();
 }
 
 static void Inkay_SetPluginRunning() {
@@ -122,10 +113,76 @@ static InkayStatus Inkay_GetStatus() {
     }
 }
 
-static void Inkay_Initialize(bool apply_patches, bool show_startup_toast, inkay_language language) {
-    if (Config::initialized)
-        return;
+static bool apply_iosu_patches() {
+    // switching back after a revert - we already know exactly what to write
+    if (iosu_journal_recorded()) {
+        return iosu_journal_reapply();
+    }
+
+    bool ok;
+    if (is555(get_console_os_version())) {
+        ok = iosu_journal_write32(0xE1019F78, 0xE3A00001); // mov r0, #1
+    } else {
+        ok = iosu_journal_write32(0xE1019E84, 0xE3A00001); // mov r0, #1
+    }
+
+    for (const auto &patch: url_patches) {
+        ok &= iosu_journal_write_string(patch.address, patch.url);
+    }
+    // a partial set gets rolled back and recorded again rather than reapplied
+    if (ok) {
+        iosu_journal_seal();
+    }
+    return ok;
+}
 
+static void refresh_nim_boss() {
+    // IOS-NIM-BOSS GlobalPolicyList->state: poking this forces a refresh after we changed the url
+    IPC_CALL(IPC_IOSU_KERNEL, Mocha_IOSUKernelWrite32(0xE24B3D90, 4));
+}
+
+// what apply_iosu_patches and refresh_nim_boss cost on a first run: a read and a write per journalled word, one more
+// read for each string's partial last word, and the policy list poke
+static uint32_t iosu_patch_round_trips() {
+    uint32_t trips = 2 + 1;
+    for (const auto &patch: url_patches) {
+        const uint32_t len = strlen(patch.url) + 1;
+        trips += (len + 3) / 4 * 2 + (len % 4 ? 1 : 0);
+    }
+    return trips;
+}
+
+// nothing here should need IOSU or FunctionPatcher - just the title's version from MCP (open, update, base, close)
+static constexpr ipc_budget title_switch_budget = {
+        0, // IOSU kernel
+        4, // MCP
+        0, // UserConfig
+        0, // FunctionPatcher
+};
+
+static bool function_patcher_ready = false;
+
+static void install_hooks() {
+    install_olv_url_patches();
+
+    if (!function_patcher_ready) {
+        function_patcher_ready = IPC_CALL(IPC_FUNCTION_PATCHER, FunctionPatcher_InitLibrary()) ==
+                                 FUNCTION_PATCHER_RESULT_SUCCESS;
+        if (!function_patcher_ready) {
+            DEBUG_FUNCTION_LINE("FunctionPatcher_InitLibrary failed");
+            return;
+        }
+    }
+
+    patchDNS();
+    patchEshop();
+    patchOlvApplet();
+    patchAccountSettings();
+    patchIdbe();
+    install_matchmaking_patches();
+}
+
+static void initialize(bool apply_patches, bool show_startup_toast, inkay_language language) {
     Config::show_startup_toast = show_startup_toast;
 
     if (Config::block_initialize) {
@@ -137,18 +194,8 @@ static void Inkay_Initialize(bool apply_patches, bool show_startup_toast, inkay_
     if (apply_patches) {
         Config::connect_to_network = true;
 
-        if (is555(get_console_os_version())) {
-            Mocha_IOSUKernelWrite32(0xE1019F78, 0xE3A00001); // mov r0, #1
-        } else {
-            Mocha_IOSUKernelWrite32(0xE1019E84, 0xE3A00001); // mov r0, #1
-        }
-
-        for (const auto &patch: url_patches) {
-            write_string(patch.address, patch.url);
-        }
-
-        // IOS-NIM-BOSS GlobalPolicyList->state: poking this forces a refresh after we changed the url
-        Mocha_IOSUKernelWrite32(0xE24B3D90, 4);
+        apply_iosu_patches();
+        refresh_nim_boss();
 
         DEBUG_FUNCTION_LINE_VERBOSE("Pretendo URL and NoSSL patches applied successfully.");
 
@@ -166,15 +213,121 @@ static void Inkay_Initialize(bool apply_patches, bool show_startup_toast, inkay_
         return;
     }
 
-    if (FunctionPatcher_InitLibrary() == FUNCTION_PATCHER_RESULT_SUCCESS) {
-        patchDNS();
-        patchEshop();
-        patchOlvApplet();
-        patchAccountSettings();
-        install_matchmaking_patches();
+    install_hooks();
+}
+
+static void Inkay_Initialize(bool apply_patches, bool show_startup_toast, inkay_language language) {
+    if (Config::initialized)
+        return;
+
+    ipc_phase_begin(IPC_PHASE_INITIALIZE);
+    initialize(apply_patches, show_startup_toast, language);
+
+    const ipc_budget budget = {
+            iosu_patch_round_trips(), // IOSU kernel
+            0,                        // MCP - the system version is in the WUMS_INITIALIZE snapshot
+            0,                        // UserConfig
+            // FunctionPatcher_InitLibrary, then DNS (2), eShop (3), Miiverse (3), Account Settings (3), IDBE (1) and
+            // NEX (4)
+            1 + 16,
+    };
+    ipc_phase_end(IPC_PHASE_INITIALIZE, budget);
+}
+
+static void apply_title_patches() {
+    const auto &title = current_title();
+
+    // the pack can change under the title cache, so it always gets its (single) lookup
+    run_patch_pack(title);
+
+    // if this title needed nothing last time, it needs nothing now - nn_olv loading later is still handled by
+    // its RPL subscription
+    if (const auto *cached = title_cache_find(title); cached && (cached->flags & TITLE_CACHE_NOTHING_TO_PATCH)) {
+        DEBUG_FUNCTION_LINE_VERBOSE("Inkay: nothing to patch for %016llX (cached)", title.title_id);
+        return;
+    }
+
+    const bool olv_loaded = check_olv_libs();
+    setup_olv_libs();
+    const int patches = run_title_patches(title);
+
+    // only trust a negative result if we were actually allowed to patch
+    if (Config::connect_to_network && !olv_loaded && patches == 0) {
+        title_cache_set(title, TITLE_CACHE_NOTHING_TO_PATCH);
+    }
+}
+
+// times the nn_olv URL scan over all of MEM2 without writing anything, to judge scan engine changes on real memory
+static void Inkay_BenchmarkScan() {
+    uint32_t base, size;
+    if (OSGetMemBound(OS_MEM2, &base, &size)) return;
+
+    PatchTransaction dry_run;
+    ScanQueue queue(&dry_run);
+    queue.add(original_url, sizeof(original_url), new_url, sizeof(new_url), match_policy::All);
+    queue.run(base, size);
+    log_scan_stats("MEM2 benchmark", queue.stats());
+}
+
+static bool Inkay_GetIpcStats(uint32_t phase, ipc_totals *out) {
+    if (phase >= IPC_PHASE_COUNT || !out) return false;
+
+    *out = ipc_phase_totals((ipc_phase) phase);
+    return true;
+}
+
+// size is sizeof(system_info) on the caller's side, so a plugin built against a different layout gets nothing
+static bool Inkay_GetSystemInfo(system_info *out, uint32_t size) {
+    if (!out || size != sizeof(system_info)) return false;
+
+    *out = get_system_info();
+    return true;
+}
+
+static void Inkay_DumpHookStats() {
+    hook_stats_dump();
+}
+
+static uint32_t Inkay_SetNetwork(bool pretendo) {
+    if (!Config::initialized) {
+        return INKAY_RELAUNCH_UNSUPPORTED;
+    }
+    if (pretendo == Config::connect_to_network) {
+        return INKAY_RELAUNCH_NONE;
+    }
+
+    uint32_t reasons = INKAY_RELAUNCH_NONE;
+    if (pretendo) {
+        if (!apply_iosu_patches()) {
+            DEBUG_FUNCTION_LINE("Inkay: failed to apply IOSU patches, rolling back");
+            iosu_journal_revert();
+            return INKAY_RELAUNCH_UNSUPPORTED;
+        }
+        Config::connect_to_network = true;
+        install_hooks();
+        // the running title's memory is left for the next APPLICATION_STARTS to patch - scanning it from under the
+        // config menu would stall the title. nothing to do if it had nothing to patch the last time it ran
+        const auto *cached = title_cache_find(current_title());
+        if (!cached || !(cached->flags & TITLE_CACHE_NOTHING_TO_PATCH)) {
+            reasons |= INKAY_RELAUNCH_RUNNING_TITLE;
+        }
     } else {
-        DEBUG_FUNCTION_LINE("FunctionPatcher_InitLibrary failed");
+        hooks_remove_all();
+        Config::connect_to_network = false;
+        // the running title's journalled patches come out too
+        patch_journal_rollback();
+        olv_url_reverted();
+        if (!iosu_journal_revert()) {
+            DEBUG_FUNCTION_LINE("Inkay: failed to revert IOSU patches");
+            return INKAY_RELAUNCH_UNSUPPORTED;
+        }
     }
+    refresh_nim_boss();
+
+    DEBUG_FUNCTION_LINE_VERBOSE("Inkay: switched to %s", pretendo ? "Pretendo" : "Nintendo");
+    // heap recolours and the like were never journalled
+    if (patch_journal_untracked()) reasons |= INKAY_RELAUNCH_RUNNING_TITLE;
+    return reasons;
 }
 
 WUMS_INITIALIZE() {
@@ -189,16 +342,17 @@ WUMS_INITIALIZE() {
     if (NotificationModule_InitLibrary() != NOTIFICATION_MODULE_RESULT_SUCCESS) {
         DEBUG_FUNCTION_LINE("NotificationModule_InitLibrary failed");
     }
+
+    // ask UC and MCP everything once, the plugin gets a copy through Inkay_GetSystemInfo
+    get_system_info();
 }
 
 WUMS_DEINITIALIZE() {
-    unpatchDNS();
-    unpatchEshop();
-    unpatchOlvApplet();
-    unpatchAccountSettings();
-    remove_matchmaking_patches();
+    hooks_remove_all();
+    patch_journal_rollback();
 
     Mocha_DeInitLibrary();
+    FlushNotifications();
     NotificationModule_DeInitLibrary();
     FunctionPatcher_DeInitLibrary();
 
@@ -208,17 +362,35 @@ WUMS_DEINITIALIZE() {
 
 WUMS_APPLICATION_STARTS() {
     DEBUG_FUNCTION_LINE_VERBOSE("Inkay " INKAY_VERSION " starting up...\n");
+    ipc_phase_begin(IPC_PHASE_TITLE_SWITCH);
+#ifdef HOOK_STATS
+    hook_stats_process_start();
+#endif
+    HOOK_STATS_SCOPE(HOOK_TITLE_START);
 
     // Reset plugin loaded flag
     Config::plugin_is_loaded = false;
+    patch_journal_reset();
+
+    sd_file_process_start();
+    title_cache_init(INKAY_VERSION);
+    patch_pack_load();
+    // the last process's nn_olv is gone, so this one's URL still needs patching
+    olv_url_reverted();
+    olv_applet_process_start();
+    // new process, new set of RPLs - this also lets patches apply as soon as their RPL is there
+    rpl_index_init();
+    // one snapshot of the title for every patch module, rather than each asking MCP for itself
+    title_context_refresh();
+    idbe_cache_process_start();
+    rpl_index_replay();
+    matchmaking_notify_titleswitch();
 }
 
 WUMS_ALL_APPLICATION_STARTS_DONE() {
+    HOOK_STATS_SCOPE(HOOK_TITLE_START);
     // we need to do the patches here because otherwise the Config::connect_to_network flag might be set yet
-    setup_olv_libs();
-    peertopeer_patch();
-    matchmaking_notify_titleswitch();
-    hotpatchAccountSettings();
+    apply_title_patches();
 
     if (Config::initialized && !Config::plugin_is_loaded) {
         DEBUG_FUNCTION_LINE("Inkay is running but the plugin got unloaded");
@@ -234,11 +406,32 @@ WUMS_ALL_APPLICATION_STARTS_DONE() {
     if (!Config::initialized) {
         Config::block_initialize = true;
     }
+
+    ipc_phase_end(IPC_PHASE_TITLE_SWITCH, title_switch_budget);
 }
 
 WUMS_APPLICATION_ENDS() {
+#ifdef HOOK_STATS
+    hook_stats_dump();
+#endif
+    trace_drain();
+    // the sender's stack is ours, but its thread belongs to this process
+    FlushNotifications();
+    // before the applet's heap goes away under the recolor thread
+    olv_applet_process_end();
+    // the journal describes memory that's about to go away, so there's nothing left for a rollback to restore
+    patch_journal_reset();
+    rpl_index_deinit();
+    title_cache_flush();
+    idbe_cache_flush();
+    sd_file_process_end();
 }
 
 WUMS_EXPORT_FUNCTION(Inkay_Initialize);
 WUMS_EXPORT_FUNCTION(Inkay_GetStatus);
 WUMS_EXPORT_FUNCTION(Inkay_SetPluginRunning);
+WUMS_EXPORT_FUNCTION(Inkay_SetNetwork);
+WUMS_EXPORT_FUNCTION(Inkay_DumpHookStats);
+WUMS_EXPORT_FUNCTION(Inkay_GetIpcStats);
+WUMS_EXPORT_FUNCTION(Inkay_GetSystemInfo);
+WUMS_EXPORT_FUNCTION(Inkay_BenchmarkScan);
@@ -0,0 +1,29 @@
+/*  Copyright 2026 Pretendo Network contributors <pretendo.network>
+
+    Permission to use, copy, modify, and/or distribute this software for any purpose with or without fee is hereby
+    granted, provided that the above copyright notice and this permission notice appear in all copies.
+
+    THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES WITH REGARD TO THIS SOFTWARE INCLUDING ALL
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT,
+    INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER
+    IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR
+    PERFORMANCE OF THIS SOFTWARE.
+*/
+
+
+#include "lang.h"
+#include "lang_tables.h"
+
+static constexpr module_strings pick(const config_strings &s, const config_strings &en) {
+    return {
+            .using_nintendo_network = translated(s.using_nintendo_network, en.using_nintendo_network),
+            .using_pretendo_network = translated(s.using_pretendo_network, en.using_pretendo_network),
+    };
+}
+
+static constexpr auto module_tables = pick_strings<module_strings>(pick);
+
+const module_strings &get_module_strings(inkay_language language) {
+    if ((size_t) language >= module_tables.size()) return module_tables[inkay_language::English];
+    return module_tables[language];
+}
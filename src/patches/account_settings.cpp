@@ -20,18 +20,18 @@
 #include "config.h"
 #include "olv_urls.h"
 #include "utils/logger.h"
+#include "utils/heap_walk.h"
+#include "utils/hook_registry.h"
+#include "utils/hook_stats.h"
+#include "utils/patch_txn.h"
 #include "utils/replace_mem.h"
+#include "utils/rootca_redirect.h"
+#include "utils/title_context.h"
 #include "inkay_config.h"
 
 #include <function_patcher/function_patching.h>
 
 #include <coreinit/filesystem.h>
-#include <coreinit/title.h>
-
-#include <vector>
-#include <optional>
-
-#include "ca_pem.h" // generated at buildtime
 
 #define ACCOUNT_SETTINGS_TID_J 0x000500101004B000
 #define ACCOUNT_SETTINGS_TID_U 0x000500101004B100
@@ -61,84 +61,75 @@ constexpr char wave_original[] = "saccount.nintendo.net";
 
 constexpr char wave_new[] =      "saccount." NETWORK_BASEURL;
 
-static bool isAccountSettingsTitle() {
-    return (OSGetTitleID() != 0 && (
-        OSGetTitleID() == ACCOUNT_SETTINGS_TID_J ||
-        OSGetTitleID() == ACCOUNT_SETTINGS_TID_U ||
-        OSGetTitleID() == ACCOUNT_SETTINGS_TID_E
+static bool isAccountSettingsTitle(const title_context &title) {
+    return (title.title_id != 0 && (
+        title.title_id == ACCOUNT_SETTINGS_TID_J ||
+        title.title_id == ACCOUNT_SETTINGS_TID_U ||
+        title.title_id == ACCOUNT_SETTINGS_TID_E
         ));
 }
 
-static std::optional<FSFileHandle> rootca_pem_handle{};
-std::vector<PatchedFunctionHandle> account_patches;
+static bool isAccountSettingsTitle() {
+    return isAccountSettingsTitle(current_title());
+}
+
+static RootCaRedirect rootca(TRACE_HOOK_ACCOUNT);
+static mem_region account_regions[512];
 
 DECL_FUNCTION(int, FSOpenFile_accSettings, FSClient *client, FSCmdBlock *block, char *path, const char *mode, uint32_t *handle,
               int error) {
+    HOOK_STATS_SCOPE(HOOK_ACCOUNT_FSOPENFILE);
     if(!isAccountSettingsTitle()) {
-        return real_FSOpenFile_accSettings(client, block, path, mode, handle, error);
+        return HOOK_REAL(real_FSOpenFile_accSettings, client, block, path, mode, handle, error);
     }
 
     if (!Config::connect_to_network) {
         DEBUG_FUNCTION_LINE_VERBOSE("Inkay: account settings patches skipped.");
-        return real_FSOpenFile_accSettings(client, block, path, mode, handle, error);
+        return HOOK_REAL(real_FSOpenFile_accSettings, client, block, path, mode, handle, error);
     }
 
     // Check for root CA file and take note of its handle
-    if (strcmp("vol/content/browser/rootca.pem", path) == 0) {
-        int ret = real_FSOpenFile_accSettings(client, block, path, mode, handle, error);
-        rootca_pem_handle = *handle;
-        DEBUG_FUNCTION_LINE_VERBOSE("Inkay: Found account settings CA, replacing...");
+    if (RootCaRedirect::is_rootca(path)) {
+        int ret = HOOK_REAL(real_FSOpenFile_accSettings, client, block, path, mode, handle, error);
+        rootca.opened(ret, *handle);
         return ret;
     }
-    return real_FSOpenFile_accSettings(client, block, path, mode, handle, error);
+    return HOOK_REAL(real_FSOpenFile_accSettings, client, block, path, mode, handle, error);
 }
 
 DECL_FUNCTION(FSStatus, FSReadFile_accSettings, FSClient *client, FSCmdBlock *block, uint8_t *buffer, uint32_t size, uint32_t count,
               FSFileHandle handle, uint32_t unk1, uint32_t flags) {
+    HOOK_STATS_SCOPE(HOOK_ACCOUNT_FSREADFILE);
     if(!isAccountSettingsTitle()) {
-        return real_FSReadFile_accSettings(client, block, buffer, size, count, handle, unk1, flags);
+        return HOOK_REAL(real_FSReadFile_accSettings, client, block, buffer, size, count, handle, unk1, flags);
     }
-    if (size != 1) {
-        DEBUG_FUNCTION_LINE("Inkay: account settings CA replacement failed!");
-    }
-
-    if (rootca_pem_handle && *rootca_pem_handle == handle) {
-        strlcpy((char *) buffer, (const char *) ca_pem, size * count);
+    if (rootca.read(handle, buffer, size, count)) {
         return (FSStatus) count;
     }
-    return real_FSReadFile_accSettings(client, block, buffer, size, count, handle, unk1, flags);
+    return HOOK_REAL(real_FSReadFile_accSettings, client, block, buffer, size, count, handle, unk1, flags);
 }
 
 DECL_FUNCTION(FSStatus, FSCloseFile_accSettings, FSClient *client, FSCmdBlock *block, FSFileHandle handle, FSErrorFlag errorMask) {
+    HOOK_STATS_SCOPE(HOOK_ACCOUNT_FSCLOSEFILE);
     if(!isAccountSettingsTitle()) {
-        return real_FSCloseFile_accSettings(client, block, handle, errorMask);
+        return HOOK_REAL(real_FSCloseFile_accSettings, client, block, handle, errorMask);
     }
-    if (handle == rootca_pem_handle) {
-        rootca_pem_handle.reset();
-    }
-    return real_FSCloseFile_accSettings(client, block, handle, errorMask);
+    rootca.closed(handle);
+    return HOOK_REAL(real_FSCloseFile_accSettings, client, block, handle, errorMask);
 }
 
+static const hook_def account_hooks[] = {
+        {REPLACE_FUNCTION_FOR_PROCESS(FSOpenFile_accSettings, LIBRARY_COREINIT, FSOpenFile, FP_TARGET_PROCESS_GAME), "FSOpenFile_accSettings"},
+        {REPLACE_FUNCTION_FOR_PROCESS(FSReadFile_accSettings, LIBRARY_COREINIT, FSReadFile, FP_TARGET_PROCESS_GAME), "FSReadFile_accSettings"},
+        {REPLACE_FUNCTION_FOR_PROCESS(FSCloseFile_accSettings, LIBRARY_COREINIT, FSCloseFile, FP_TARGET_PROCESS_GAME), "FSCloseFile_accSettings"},
+};
+
 bool patchAccountSettings() {
-    account_patches.reserve(3);
-
-    auto add_patch = [](function_replacement_data_t repl, const char *name) {
-        PatchedFunctionHandle handle = 0;
-        if (FunctionPatcher_AddFunctionPatch(&repl, &handle, nullptr) != FUNCTION_PATCHER_RESULT_SUCCESS) {
-            DEBUG_FUNCTION_LINE("Inkay/Account: Failed to patch %s!", name);
-        }
-        account_patches.push_back(handle);
-    };
-
-    add_patch(REPLACE_FUNCTION_FOR_PROCESS(FSOpenFile_accSettings, LIBRARY_COREINIT, FSOpenFile, FP_TARGET_PROCESS_GAME), "FSOpenFile_accSettings");
-    add_patch(REPLACE_FUNCTION_FOR_PROCESS(FSReadFile_accSettings, LIBRARY_COREINIT, FSReadFile, FP_TARGET_PROCESS_GAME), "FSReadFile_accSettings");
-    add_patch(REPLACE_FUNCTION_FOR_PROCESS(FSCloseFile_accSettings, LIBRARY_COREINIT, FSCloseFile, FP_TARGET_PROCESS_GAME), "FSCloseFile_accSettings");
-        
-    return true;
+    return hooks_install("Account", account_hooks);
 }
 
-bool hotpatchAccountSettings() {
-    if(!isAccountSettingsTitle()) {
+bool hotpatchAccountSettings(const title_context &title) {
+    if(!isAccountSettingsTitle(title)) {
         return false;
     }
 
@@ -149,22 +140,29 @@ bool hotpatchAccountSettings() {
 
     DEBUG_FUNCTION_LINE_VERBOSE("Inkay: hewwo account settings!\n");
 
-    if (!replace(0x10000000, 0x10000000, wave_original, sizeof(wave_original), wave_new, sizeof(wave_new))) {
+    // both needles in one pass - live memory first, then brute-force the old window for anything left.
+    // staged, so finding only one of them leaves the title untouched
+    PatchTransaction txn;
+    ScanQueue queue(&txn);
+    auto url = queue.add(wave_original, sizeof(wave_original), wave_new, sizeof(wave_new));
+    auto allowlist = queue.add(&original_entry, sizeof(original_entry), &new_entry, sizeof(new_entry));
+
+    queue.run(std::span(account_regions, collect_process_regions(account_regions)));
+    if (!queue.done())
+        queue.run(0x10000000, 0x10000000);
+#ifdef DEBUG
+    log_scan_stats("Account Settings", queue.stats());
+#endif
+
+    if (!queue.matches(url)) {
         DEBUG_FUNCTION_LINE("Inkay: We didn't find the url /)>~<(\\");
         return false;
     }
 
-    if (!replace(0x10000000, 0x10000000, (const char *)&original_entry, sizeof(original_entry), (const char *)&new_entry, sizeof(new_entry))) {
+    if (!queue.matches(allowlist)) {
         DEBUG_FUNCTION_LINE("Inkay: We didn't find the whitelist /)>~<(\\");
         return false;
     }
 
-    return true;
-}
-
-void unpatchAccountSettings() {
-    for (const auto handle: account_patches) {
-        FunctionPatcher_RemoveFunctionPatch(handle);
-    }
-    account_patches.clear();
+    return txn.commit();
 }
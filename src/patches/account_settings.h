@@ -15,6 +15,7 @@
 
 #pragma once
 
+#include "utils/title_context.h"
+
 bool patchAccountSettings();
-bool hotpatchAccountSettings();
-void unpatchAccountSettings();
+bool hotpatchAccountSettings(const title_context &title);
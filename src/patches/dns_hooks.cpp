@@ -20,12 +20,12 @@
 #include "config.h"
 #include "utils/logger.h"
 #include "inkay_config.h"
+#include "utils/hook_registry.h"
+#include "utils/hook_stats.h"
+#include "utils/trace.h"
 #include <array>
-#include <vector>
 #include <function_patcher/function_patching.h>
 
-std::vector<PatchedFunctionHandle> dns_patches;
-
 constexpr std::pair<const char *, const char *> dns_replacements[] = {
         // NNCS servers
         { "nncs1.app.nintendowifi.net", "nncs1.app." NETWORK_BASEURL },
@@ -33,44 +33,35 @@ constexpr std::pair<const char *, const char *> dns_replacements[] = {
 };
 
 static const char * replace_dns_name(const char *dns_name) {
-    if (!Config::connect_to_network) return dns_name;
+    // getaddrinfo allows a null node for service-only lookups
+    if (!dns_name || !Config::connect_to_network) return dns_name;
 
-    for (auto [original, replacement] : dns_replacements) {
-        if (strcmp(original, dns_name) == 0)
-            return replacement;
+    for (uint32_t i = 0; i < std::size(dns_replacements); i++) {
+        if (strcmp(dns_replacements[i].first, dns_name) == 0) {
+            trace(TRACE_DNS_REPLACED, i);
+            return dns_replacements[i].second;
+        }
     }
 
     return dns_name;
 }
 
 DECL_FUNCTION(struct hostent *, gethostbyname, const char *dns_name) {
-    return real_gethostbyname(replace_dns_name(dns_name));
+    HOOK_STATS_SCOPE(HOOK_GETHOSTBYNAME);
+    return HOOK_REAL(real_gethostbyname, replace_dns_name(dns_name));
 }
 
 DECL_FUNCTION(int, getaddrinfo, const char *node, const char *service, const struct addrinfo *hints, struct addrinfo **res) {
-    return real_getaddrinfo(replace_dns_name(node), service, hints, res);
+    HOOK_STATS_SCOPE(HOOK_GETADDRINFO);
+    return HOOK_REAL(real_getaddrinfo, replace_dns_name(node), service, hints, res);
 }
 
-void patchDNS() {
-    dns_patches.reserve(2);
-
-    auto add_patch = [](function_replacement_data_t repl, const char *name) {
-        PatchedFunctionHandle handle = 0;
-        if (FunctionPatcher_AddFunctionPatch(&repl, &handle, nullptr) != FUNCTION_PATCHER_RESULT_SUCCESS) {
-            DEBUG_FUNCTION_LINE("Inkay/DNS: Failed to patch %s!", name);
-        }
-        dns_patches.push_back(handle);
-    };
-
-    // might need a REPLACE_FUNCTION_FOR_PROCESS for Friends
-    add_patch(REPLACE_FUNCTION(gethostbyname, LIBRARY_NSYSNET, gethostbyname), "gethostbyname");
-
-    add_patch(REPLACE_FUNCTION(getaddrinfo, LIBRARY_NSYSNET, getaddrinfo), "getaddrinfo");
-}
+static const hook_def dns_hooks[] = {
+        // might need a REPLACE_FUNCTION_FOR_PROCESS for Friends
+        {REPLACE_FUNCTION(gethostbyname, LIBRARY_NSYSNET, gethostbyname), "gethostbyname"},
+        {REPLACE_FUNCTION(getaddrinfo, LIBRARY_NSYSNET, getaddrinfo), "getaddrinfo"},
+};
 
-void unpatchDNS() {
-    for (auto handle: dns_patches) {
-        FunctionPatcher_RemoveFunctionPatch(handle);
-    }
-    dns_patches.clear();
+void patchDNS() {
+    hooks_install("DNS", dns_hooks);
 }
@@ -19,18 +19,18 @@
 #include "config.h"
 #include "olv_urls.h"
 #include "utils/logger.h"
+#include "utils/heap_walk.h"
+#include "utils/hook_registry.h"
+#include "utils/hook_stats.h"
 #include "utils/replace_mem.h"
+#include "utils/rootca_redirect.h"
 #include "inkay_config.h"
 
-#include <vector>
 #include <function_patcher/function_patching.h>
-#include <optional>
 #include <coreinit/debug.h>
 #include <coreinit/filesystem.h>
 #include <nsysnet/nssl.h>
 
-#include "ca_pem.h" // generated at buildtime
-
 constexpr char wave_original[] = "https://ninja.wup.shop.nintendo.net/ninja/wood_index.html?";
 constexpr char wave_new[] =      "http://samurai.wup.shop." NETWORK_BASEURL "/ninja/wood_index.html?";
 
@@ -55,16 +55,17 @@ constexpr struct eshop_allowlist new_entry = {
     .flags = {1, 1, 1, 1, 0},
 };
 
-static std::optional<FSFileHandle> rootca_pem_handle{};
-std::vector<PatchedFunctionHandle> eshop_patches;
+static RootCaRedirect rootca(TRACE_HOOK_ESHOP);
+static mem_region eshop_regions[512];
 
 DECL_FUNCTION(int, FSOpenFile_eShop, FSClient *client, FSCmdBlock *block, char *path, const char *mode, uint32_t *handle,
               int error) {
+    HOOK_STATS_SCOPE(HOOK_ESHOP_FSOPENFILE);
     const char *initialOma = "vol/content/initial.oma";
 
     if (!Config::connect_to_network) {
         DEBUG_FUNCTION_LINE_VERBOSE("Inkay: eShop patches skipped.");
-        return real_FSOpenFile_eShop(client, block, path, mode, handle, error);
+        return HOOK_REAL(real_FSOpenFile_eShop, client, block, path, mode, handle, error);
     }
 
     if (strcmp(initialOma, path) == 0) {
@@ -73,64 +74,56 @@ DECL_FUNCTION(int, FSOpenFile_eShop, FSClient *client, FSCmdBlock *block, char *
 
         DEBUG_FUNCTION_LINE_VERBOSE("Inkay: hewwo eShop!\n");
 
-        if (!replace(0x10000000, 0x10000000, wave_original, sizeof(wave_original), wave_new, sizeof(wave_new)))
-            DEBUG_FUNCTION_LINE_VERBOSE("Inkay: We didn't find the url /)>~<(\\");
+        // both needles in one pass - live memory first, then brute-force the old window for anything left
+        ScanQueue queue;
+        auto url = queue.add(wave_original, sizeof(wave_original), wave_new, sizeof(wave_new));
+        auto allowlist = queue.add(&original_entry, sizeof(original_entry), &new_entry, sizeof(new_entry));
+
+        queue.run(std::span(eshop_regions, collect_process_regions(eshop_regions)));
+        if (!queue.done())
+            queue.run(0x10000000, 0x10000000);
+#ifdef DEBUG
+        log_scan_stats("eShop", queue.stats());
+#endif
 
-        if (!replace(0x10000000, 0x10000000, (const char *)&original_entry, sizeof(original_entry), (const char *)&new_entry, sizeof(new_entry)))
+        if (!queue.matches(url))
+            DEBUG_FUNCTION_LINE_VERBOSE("Inkay: We didn't find the url /)>~<(\\");
+        if (!queue.matches(allowlist))
             DEBUG_FUNCTION_LINE_VERBOSE("Inkay: We didn't find the whitelist /)>~<(\\");
 
     // Check for root CA file and take note of its handle
-    } else if (strcmp("vol/content/browser/rootca.pem", path) == 0) {
-        int ret = real_FSOpenFile_eShop(client, block, path, mode, handle, error);
-        rootca_pem_handle = *handle;
-        DEBUG_FUNCTION_LINE_VERBOSE("Inkay: Found eShop CA, replacing...");
+    } else if (RootCaRedirect::is_rootca(path)) {
+        int ret = HOOK_REAL(real_FSOpenFile_eShop, client, block, path, mode, handle, error);
+        rootca.opened(ret, *handle);
         return ret;
     }
 
-    return real_FSOpenFile_eShop(client, block, path, mode, handle, error);
+    return HOOK_REAL(real_FSOpenFile_eShop, client, block, path, mode, handle, error);
 }
 
 DECL_FUNCTION(FSStatus, FSReadFile_eShop, FSClient *client, FSCmdBlock *block, uint8_t *buffer, uint32_t size, uint32_t count,
               FSFileHandle handle, uint32_t unk1, uint32_t flags) {
-    if (size != 1) {
-        DEBUG_FUNCTION_LINE("Inkay: eShop CA replacement failed!");
-    }
-
-    if (rootca_pem_handle && *rootca_pem_handle == handle) {
-        strlcpy((char *) buffer, (const char *) ca_pem, size * count);
+    HOOK_STATS_SCOPE(HOOK_ESHOP_FSREADFILE);
+    if (rootca.read(handle, buffer, size, count)) {
         return (FSStatus) count;
     }
 
-    return real_FSReadFile_eShop(client, block, buffer, size, count, handle, unk1, flags);
+    return HOOK_REAL(real_FSReadFile_eShop, client, block, buffer, size, count, handle, unk1, flags);
 }
 
 DECL_FUNCTION(FSStatus, FSCloseFile_eShop, FSClient *client, FSCmdBlock *block, FSFileHandle handle, FSErrorFlag errorMask) {
-    if (handle == rootca_pem_handle) {
-        rootca_pem_handle.reset();
-    }
+    HOOK_STATS_SCOPE(HOOK_ESHOP_FSCLOSEFILE);
+    rootca.closed(handle);
 
-    return real_FSCloseFile_eShop(client, block, handle, errorMask);
+    return HOOK_REAL(real_FSCloseFile_eShop, client, block, handle, errorMask);
 }
 
-void patchEshop() {
-    eshop_patches.reserve(3);
-
-    auto add_patch = [](function_replacement_data_t repl, const char *name) {
-        PatchedFunctionHandle handle = 0;
-        if (FunctionPatcher_AddFunctionPatch(&repl, &handle, nullptr) != FUNCTION_PATCHER_RESULT_SUCCESS) {
-            DEBUG_FUNCTION_LINE("Inkay/eShop: Failed to patch %s!", name);
-        }
-        eshop_patches.push_back(handle);
-    };
-
-    add_patch(REPLACE_FUNCTION_FOR_PROCESS(FSOpenFile_eShop, LIBRARY_COREINIT, FSOpenFile, FP_TARGET_PROCESS_ESHOP), "FSOpenFile_eShop");
-    add_patch(REPLACE_FUNCTION_FOR_PROCESS(FSReadFile_eShop, LIBRARY_COREINIT, FSReadFile, FP_TARGET_PROCESS_ESHOP), "FSReadFile_eShop");
-    add_patch(REPLACE_FUNCTION_FOR_PROCESS(FSCloseFile_eShop, LIBRARY_COREINIT, FSCloseFile, FP_TARGET_PROCESS_ESHOP), "FSCloseFile_eShop");
-}
+static const hook_def eshop_hooks[] = {
+        {REPLACE_FUNCTION_FOR_PROCESS(FSOpenFile_eShop, LIBRARY_COREINIT, FSOpenFile, FP_TARGET_PROCESS_ESHOP), "FSOpenFile_eShop"},
+        {REPLACE_FUNCTION_FOR_PROCESS(FSReadFile_eShop, LIBRARY_COREINIT, FSReadFile, FP_TARGET_PROCESS_ESHOP), "FSReadFile_eShop"},
+        {REPLACE_FUNCTION_FOR_PROCESS(FSCloseFile_eShop, LIBRARY_COREINIT, FSCloseFile, FP_TARGET_PROCESS_ESHOP), "FSCloseFile_eShop"},
+};
 
-void unpatchEshop() {
-    for (auto handle: eshop_patches) {
-        FunctionPatcher_RemoveFunctionPatch(handle);
-    }
-    eshop_patches.clear();
+void patchEshop() {
+    hooks_install("eShop", eshop_hooks);
 }
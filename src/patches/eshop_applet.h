@@ -17,4 +17,3 @@
 #pragma once
 
 void patchEshop();
-void unpatchEshop();
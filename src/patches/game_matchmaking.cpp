@@ -18,80 +18,171 @@
 
 #include "config.h"
 #include "game_matchmaking.h"
+#include "utils/hook_registry.h"
+#include "utils/hook_stats.h"
+#include "utils/trace.h"
 #include "utils/logger.h"
+#include "utils/sd_file.h"
 
 #include "ini.h"
-#include <array>
-#include <optional>
-#include <string>
-#include <vector>
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <span>
+#include <coreinit/title.h>
 #include <function_patcher/function_patching.h>
 
-#define MARIO_KART_8_TID_J 0x000500001010EB00
-#define MARIO_KART_8_TID_U 0x000500001010EC00
-#define MARIO_KART_8_TID_E 0x000500001010ED00
+// NEX matchmake sessions carry 6 attributes, leave a bit of room
+#define NEX_MAX_ATTRIBUTES 8
 
-constexpr std::array<uint64_t, 3> mk8_tids = {MARIO_KART_8_TID_J, MARIO_KART_8_TID_U, MARIO_KART_8_TID_E};
-std::vector<PatchedFunctionHandle> matchmaking_patches;
+enum class nex_hook_kind {
+    Session,        ///< MatchmakeSession::SetAttribute(index, value)
+    SearchCriteria, ///< MatchmakeSessionSearchCriteria::SetAttribute(index, value)
+};
+
+struct nex_hook {
+    nex_hook_kind kind;
+    uint32_t address;
+    uint16_t version;
+};
+
+/**
+ * A NEX title we can isolate modpack matchmaking for. Supporting another game is just another row here - the rewrite
+ * rules themselves come from the modpack's pretendo.ini.
+ */
+struct nex_title {
+    std::span<const uint64_t> title_ids;
+    const char *rpx;
+    const char *name;
+    uint8_t dlc_attribute; ///< attribute the ini's dlc_id shorthand rewrites
+    std::span<const nex_hook> hooks;
+};
+
+static constexpr uint64_t mk8_tids[] = {0x000500001010EB00, 0x000500001010EC00, 0x000500001010ED00};
+static constexpr nex_hook mk8_hooks[] = {
+        {nex_hook_kind::SearchCriteria, 0x0098e7b4, 64},
+        {nex_hook_kind::SearchCriteria, 0x0098eafc, 81},
+        {nex_hook_kind::Session,        0x0098e52c, 64},
+        {nex_hook_kind::Session,        0x0098e874, 81},
+};
+
+static constexpr nex_title nex_titles[] = {
+        {mk8_tids, "Turbo.rpx", "Mario Kart 8", 4, mk8_hooks},
+};
 
-struct modpack {
-    std::string name = "Mario Kart 8";
-    int dlc_id = -1;
+static constexpr size_t max_hooks = [] {
+    size_t count = 0;
+    for (const auto &title: nex_titles) count += title.hooks.size();
+    return count;
+}();
+
+// the rules for the running title, flattened so the hooks are a bounds check and a bit test
+struct attribute_rules {
+    uint32_t mask; ///< bit i set = rewrite attribute i
+    uint32_t values[NEX_MAX_ATTRIBUTES];
+    char name[64];
 };
-std::optional<modpack> dlc_modpack;
+static attribute_rules rules;
+
+static void set_rule(uint32_t index, const char *value) {
+    if (index >= NEX_MAX_ATTRIBUTES) {
+        DEBUG_FUNCTION_LINE("Inkay/NEX: Attribute %u out of range, ignoring", index);
+        return;
+    }
+
+    const auto attr = (uint32_t) std::strtoul(value, nullptr, 16);
+    // -1 is how modpacks say "leave this one alone"
+    if (attr == UINT32_MAX) {
+        rules.mask &= ~(1u << index);
+        return;
+    }
+
+    rules.values[index] = attr;
+    rules.mask |= 1u << index;
+}
 
 static int handler(void *user, const char *section, const char *name, const char *value) {
-    auto *mod = (modpack *) user;
-    auto match = [section, name](const char *s, const char *n) -> bool {
-        return strcmp(section, s) == 0 && strcmp(name, n) == 0;
-    };
-
-    if (match("pretendo", "name")) {
-        mod->name = value;
-    } else if (match("pretendo", "dlc_id")) {
-        mod->dlc_id = std::strtol(value, nullptr, 16);
+    const auto *title = (const nex_title *) user;
+
+    if (strcmp(section, "pretendo") == 0) {
+        if (strcmp(name, "name") == 0) {
+            snprintf(rules.name, sizeof(rules.name), "%s", value);
+        } else if (strcmp(name, "dlc_id") == 0) {
+            set_rule(title->dlc_attribute, value);
+        } else return 0;
+    } else if (strcmp(section, "attributes") == 0) {
+        char *end;
+        const auto index = std::strtoul(name, &end, 10);
+        if (*end != '\0') return 0;
+        set_rule(index, value);
     } else return 0;
 
     return 1;
 }
 
-static void check_modpack() {
-    modpack mod;
-    if (ini_parse("fs:/vol/content/pretendo.ini", handler, &mod)) {
-        DEBUG_FUNCTION_LINE_VERBOSE("Inkay/MK8: Doesn't look like a modpack");
+// a modpack's pretendo.ini is a handful of lines
+#define NEX_MAX_INI_SIZE 0x800
+static char ini_text[NEX_MAX_INI_SIZE + 1];
+
+// runs once per title, at title start - the hooks only ever do a table lookup
+static void load_rules(const nex_title &title) {
+    rules = {};
+    snprintf(rules.name, sizeof(rules.name), "%s", title.name);
+
+    const auto size = read_whole_file("fs:/vol/content/pretendo.ini",
+                                      std::span((uint8_t *) ini_text, NEX_MAX_INI_SIZE));
+    if (!size) {
+        DEBUG_FUNCTION_LINE_VERBOSE("Inkay/NEX: Doesn't look like a modpack");
+    } else {
+        ini_text[*size] = '\0';
+        if (ini_parse_string(ini_text, handler, (void *) &title)) {
+            DEBUG_FUNCTION_LINE("Inkay/NEX: Couldn't parse pretendo.ini");
+        }
     }
 
-    DEBUG_FUNCTION_LINE("Inkay/MK8: Playing %s (%08x)", mod.name.c_str(), mod.dlc_id);
-    dlc_modpack = mod;
+    DEBUG_FUNCTION_LINE("Inkay/NEX: Playing %s (rewriting attributes %02x)", rules.name, rules.mask);
 }
 
-DECL_FUNCTION(void, mk8_MatchmakeSessionSearchCriteria_SetAttribute, void *_this, uint32_t attributeIndex,
-              uint32_t attributeValue) {
-    if (attributeIndex == 4) {
-        if (!dlc_modpack) check_modpack();
-
-        const int dlc_id = dlc_modpack->dlc_id;
-        if (dlc_id != -1) {
-            DEBUG_FUNCTION_LINE_VERBOSE("Inkay/MK8: Searching for %s session (%08x)", dlc_modpack->name.c_str(), dlc_id);
-            attributeValue = dlc_id;
-        }
+static uint32_t rewrite_attribute(uint32_t index, uint32_t value) {
+    if (index < NEX_MAX_ATTRIBUTES && (rules.mask & (1u << index))) {
+        trace(TRACE_NEX_ATTRIBUTE, index, rules.values[index]);
+        return rules.values[index];
     }
+    return value;
+}
 
-    real_mk8_MatchmakeSessionSearchCriteria_SetAttribute(_this, attributeIndex, attributeValue);
+DECL_FUNCTION(void, nex_MatchmakeSessionSearchCriteria_SetAttribute, void *_this, uint32_t attributeIndex,
+              uint32_t attributeValue) {
+    HOOK_STATS_SCOPE(HOOK_NEX_SEARCH_SETATTRIBUTE);
+    attributeValue = rewrite_attribute(attributeIndex, attributeValue);
+    HOOK_REAL(real_nex_MatchmakeSessionSearchCriteria_SetAttribute, _this, attributeIndex, attributeValue);
 }
 
-DECL_FUNCTION(void, mk8_MatchmakeSession_SetAttribute, void *_this, uint32_t attributeIndex, uint32_t attributeValue) {
-    if (attributeIndex == 4) {
-        if (!dlc_modpack) check_modpack();
+DECL_FUNCTION(void, nex_MatchmakeSession_SetAttribute, void *_this, uint32_t attributeIndex, uint32_t attributeValue) {
+    HOOK_STATS_SCOPE(HOOK_NEX_SESSION_SETATTRIBUTE);
+    attributeValue = rewrite_attribute(attributeIndex, attributeValue);
+    HOOK_REAL(real_nex_MatchmakeSession_SetAttribute, _this, attributeIndex, attributeValue);
+}
 
-        const int dlc_id = dlc_modpack->dlc_id;
-        if (dlc_id != -1) {
-            DEBUG_FUNCTION_LINE_VERBOSE("Inkay/MK8: Creating %s session (%08x)", dlc_modpack->name.c_str(), dlc_id);
-            attributeValue = dlc_id;
-        }
+static function_replacement_data_t make_replacement(const nex_title &title, const nex_hook &hook) {
+    switch (hook.kind) {
+        case nex_hook_kind::Session:
+            return REPLACE_FUNCTION_OF_EXECUTABLE_BY_ADDRESS_WITH_VERSION(
+                    nex_MatchmakeSession_SetAttribute,
+                    title.title_ids.data(), title.title_ids.size(),
+                    title.rpx,
+                    hook.address, hook.version, hook.version
+            );
+        case nex_hook_kind::SearchCriteria:
+        default:
+            return REPLACE_FUNCTION_OF_EXECUTABLE_BY_ADDRESS_WITH_VERSION(
+                    nex_MatchmakeSessionSearchCriteria_SetAttribute,
+                    title.title_ids.data(), title.title_ids.size(),
+                    title.rpx,
+                    hook.address, hook.version, hook.version
+            );
     }
-
-    real_mk8_MatchmakeSession_SetAttribute(_this, attributeIndex, attributeValue);
 }
 
 void install_matchmaking_patches() {
@@ -99,52 +190,31 @@ void install_matchmaking_patches() {
         return;
     }
 
-    matchmaking_patches.reserve(4);
-
-    auto add_patch = [](function_replacement_data_t repl, const char *game, const char *name) {
-        PatchedFunctionHandle handle = 0;
-        if (FunctionPatcher_AddFunctionPatch(&repl, &handle, nullptr) != FUNCTION_PATCHER_RESULT_SUCCESS) {
-            DEBUG_FUNCTION_LINE("Inkay/%s: Failed to patch %s!", game, name);
+    // addresses come from the table, so this one can't be a static array like the other modules
+    hook_def hooks[max_hooks];
+    size_t count = 0;
+    for (const auto &title: nex_titles) {
+        for (const auto &hook: title.hooks) {
+            hooks[count++] = {
+                    make_replacement(title, hook),
+                    hook.kind == nex_hook_kind::Session ? "MatchmakeSession::SetAttribute"
+                                                        : "MatchmakeSessionSearchCriteria::SetAttribute",
+            };
         }
-        matchmaking_patches.push_back(handle);
-    };
-
-    add_patch(REPLACE_FUNCTION_OF_EXECUTABLE_BY_ADDRESS_WITH_VERSION(
-                      mk8_MatchmakeSessionSearchCriteria_SetAttribute,
-                      mk8_tids.data(), mk8_tids.size(),
-                      "Turbo.rpx",
-                      0x0098e7b4, 64, 64
-              ), "MK8", "MatchmakeSessionSearchCriteria::SetAttribute");
-    add_patch(REPLACE_FUNCTION_OF_EXECUTABLE_BY_ADDRESS_WITH_VERSION(
-                      mk8_MatchmakeSessionSearchCriteria_SetAttribute,
-                      mk8_tids.data(), mk8_tids.size(),
-                      "Turbo.rpx",
-                      0x0098eafc, 81, 81
-              ), "MK8", "MatchmakeSessionSearchCriteria::SetAttribute");
-
-
-    add_patch(REPLACE_FUNCTION_OF_EXECUTABLE_BY_ADDRESS_WITH_VERSION(
-                      mk8_MatchmakeSession_SetAttribute,
-                      mk8_tids.data(), mk8_tids.size(),
-                      "Turbo.rpx",
-                      0x0098e52c, 64, 64
-              ), "MK8", "MatchmakeSession::SetAttribute");
-
-    add_patch(REPLACE_FUNCTION_OF_EXECUTABLE_BY_ADDRESS_WITH_VERSION(
-                      mk8_MatchmakeSession_SetAttribute,
-                      mk8_tids.data(), mk8_tids.size(),
-                      "Turbo.rpx",
-                      0x0098e874, 81, 81
-              ), "MK8", "MatchmakeSession::SetAttribute");
-}
-
-void remove_matchmaking_patches() {
-    for (auto handle: matchmaking_patches) {
-        FunctionPatcher_RemoveFunctionPatch(handle);
     }
-    matchmaking_patches.clear();
+
+    hooks_install("NEX", std::span(hooks, count));
 }
 
 void matchmaking_notify_titleswitch() {
-    dlc_modpack.reset();
+    rules = {};
+
+    // only NEX titles have rules to load, and the hooks only run for them
+    const auto title_id = OSGetTitleID();
+    for (const auto &title: nex_titles) {
+        if (std::ranges::find(title.title_ids, title_id) != title.title_ids.end()) {
+            load_rules(title);
+            return;
+        }
+    }
 }
@@ -15,5 +15,4 @@
 #pragma once
 
 void install_matchmaking_patches();
-void remove_matchmaking_patches();
 void matchmaking_notify_titleswitch();
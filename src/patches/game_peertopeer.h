@@ -13,4 +13,9 @@
 
 #pragma once
 
-void peertopeer_patch();
+#include "utils/title_context.h"
+
+// called through the title patch registry, which has already matched the title ID and version
+void mk8_peertopeer_patch(const title_context &title);
+void splatoon_peertopeer_patch(const title_context &title);
+void minecraft_peertopeer_patch(const title_context &title);
@@ -0,0 +1,234 @@
+/*  Copyright 2026 Pretendo Network contributors <pretendo.network>
+
+    Permission to use, copy, modify, and/or distribute this software for any purpose with or without fee is hereby
+    granted, provided that the above copyright notice and this permission notice appear in all copies.
+
+    THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES WITH REGARD TO THIS SOFTWARE INCLUDING ALL
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT,
+    INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER
+    IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR
+    PERFORMANCE OF THIS SOFTWARE.
+*/
+
+
+#include "idbe_cache.h"
+#include "config.h"
+#include "utils/hook_registry.h"
+#include "utils/hook_stats.h"
+#include "utils/logger.h"
+#include "utils/sd_file.h"
+#include "utils/title_context.h"
+#include "utils/trace.h"
+
+#include <coreinit/mutex.h>
+#include <coreinit/time.h>
+#include <function_patcher/function_patching.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+
+#define IDBE_CACHE_DIR "fs:/vol/external01/wiiu/inkay/idbe"
+#define IDBE_CACHE_INDEX IDBE_CACHE_DIR "/index.bin"
+#define IDBE_CACHE_MAGIC 0x494B4943 // IKIC
+
+#define WII_U_MENU_TID_J 0x0005001010040000
+#define WII_U_MENU_TID_U 0x0005001010040100
+#define WII_U_MENU_TID_E 0x0005001010040200
+
+// what nn::idbe hands back for a Wii U title: a SHA-256, then the encrypted icon
+#define IDBE_ICON_SIZE 0x12080
+// ~72KiB each, so a bit under 5MiB of SD card
+#define IDBE_CACHE_ENTRIES 64
+// a title update gets a new version (and so a new entry) - this is just for fixes on the server side
+#define IDBE_CACHE_MAX_AGE (7 * 24 * 60 * 60)
+
+struct idbe_cache_header {
+    uint32_t magic;
+    uint32_t count;
+};
+
+struct idbe_cache_entry {
+    uint64_t title_id;
+    uint16_t version;
+    uint16_t reserved;
+    uint32_t fetched;   ///< seconds since 2000, when the icon came from the server
+    uint32_t last_used; ///< seconds since 2000, for eviction
+};
+
+static idbe_cache_entry entries[IDBE_CACHE_ENTRIES];
+static uint32_t entry_count = 0;
+static bool loaded = false;
+static bool dirty = false;
+// decided once per Menu process, so the hook never has to stat the SD card
+static bool opted_in = false;
+
+// the Menu loads icons from more than one thread
+static OSMutex cache_mutex;
+static bool cache_mutex_ready = false;
+
+static uint32_t now() {
+    return (uint32_t) OSTicksToSeconds(OSGetTime());
+}
+
+static bool sd_opted_in() {
+    return sd_dir_exists(IDBE_CACHE_DIR);
+}
+
+static bool is_wii_u_menu(uint64_t title_id) {
+    return title_id == WII_U_MENU_TID_J || title_id == WII_U_MENU_TID_U || title_id == WII_U_MENU_TID_E;
+}
+
+static void icon_path(char (&path)[96], uint64_t title_id, uint16_t version) {
+    snprintf(path, sizeof(path), IDBE_CACHE_DIR "/%016llX-%u.idbe", (unsigned long long) title_id, version);
+}
+
+static void load_index() {
+    if (loaded) return;
+    loaded = true;
+
+    // the header, then the entries straight after it
+    static uint8_t file_data[sizeof(idbe_cache_header) + sizeof(entries)];
+    const auto size = read_whole_file(IDBE_CACHE_INDEX, file_data);
+    if (!size) return;
+
+    idbe_cache_header header = {};
+    if (*size >= sizeof(header)) memcpy(&header, file_data, sizeof(header));
+    if (header.magic == IDBE_CACHE_MAGIC && header.count <= IDBE_CACHE_ENTRIES) {
+        entry_count = std::min<uint32_t>(header.count, (*size - sizeof(header)) / sizeof(idbe_cache_entry));
+        memcpy(entries, file_data + sizeof(header), entry_count * sizeof(idbe_cache_entry));
+    }
+
+    DEBUG_FUNCTION_LINE_VERBOSE("Inkay: %u cached icons", (unsigned) entry_count);
+}
+
+static idbe_cache_entry *find_entry(uint64_t title_id, uint16_t version) {
+    for (uint32_t i = 0; i < entry_count; i++) {
+        if (entries[i].title_id == title_id && entries[i].version == version) return &entries[i];
+    }
+    return nullptr;
+}
+
+static void drop_entry(idbe_cache_entry *entry) {
+    char path[96];
+    icon_path(path, entry->title_id, entry->version);
+    remove(path);
+
+    *entry = entries[--entry_count];
+    dirty = true;
+}
+
+static bool cache_read(void *buffer, uint64_t title_id, uint16_t version) {
+    auto *entry = find_entry(title_id, version);
+    if (!entry) return false;
+
+    if (now() - entry->fetched > IDBE_CACHE_MAX_AGE) {
+        drop_entry(entry);
+        return false;
+    }
+
+    char path[96];
+    icon_path(path, title_id, version);
+    const auto size = read_whole_file(path, std::span((uint8_t *) buffer, IDBE_ICON_SIZE));
+    if (size != IDBE_ICON_SIZE) {
+        DEBUG_FUNCTION_LINE("Inkay: cached icon for %016llX is damaged", (unsigned long long) title_id);
+        drop_entry(entry);
+        return false;
+    }
+
+    entry->last_used = now();
+    dirty = true;
+    return true;
+}
+
+static void cache_store(const void *buffer, uint64_t title_id, uint16_t version) {
+    auto *entry = find_entry(title_id, version);
+    if (!entry) {
+        if (entry_count == IDBE_CACHE_ENTRIES) {
+            auto *oldest = &entries[0];
+            for (auto &e: std::span(entries, entry_count)) {
+                if (e.last_used < oldest->last_used) oldest = &e;
+            }
+            drop_entry(oldest);
+        }
+        entry = &entries[entry_count++];
+    }
+
+    char path[96];
+    icon_path(path, title_id, version);
+    FILE *file = fopen_unbuffered(path, "wb");
+    const bool written = file && fwrite(buffer, IDBE_ICON_SIZE, 1, file) == 1;
+    if (file) fclose(file);
+    if (!written) {
+        DEBUG_FUNCTION_LINE("Inkay: failed to cache the icon for %016llX", (unsigned long long) title_id);
+        *entry = entries[--entry_count];
+        return;
+    }
+
+    const auto time = now();
+    *entry = {title_id, version, 0, time, time};
+    dirty = true;
+}
+
+DECL_FUNCTION(bool, DownloadIconFile, void *buffer, uint64_t title_id, uint16_t version, bool ctr) {
+    HOOK_STATS_SCOPE(HOOK_IDBE_DOWNLOADICONFILE);
+    // 3DS icons are a different size, and rare enough not to bother
+    if (ctr || !Config::connect_to_network || !opted_in) {
+        return HOOK_REAL(real_DownloadIconFile, buffer, title_id, version, ctr);
+    }
+
+    OSLockMutex(&cache_mutex);
+    const bool hit = cache_read(buffer, title_id, version);
+    OSUnlockMutex(&cache_mutex);
+    if (hit) {
+        trace(TRACE_IDBE_HIT, (uint32_t) title_id, version);
+        return true;
+    }
+
+    const bool ok = HOOK_REAL(real_DownloadIconFile, buffer, title_id, version, ctr);
+    if (ok) {
+        OSLockMutex(&cache_mutex);
+        cache_store(buffer, title_id, version);
+        OSUnlockMutex(&cache_mutex);
+    }
+    return ok;
+}
+
+static const hook_def idbe_hooks[] = {
+        {REPLACE_FUNCTION_FOR_PROCESS(DownloadIconFile, LIBRARY_NN_IDBE, DownloadIconFile__Q2_2nn4idbeFPvULUsb,
+                                      FP_TARGET_PROCESS_WII_U_MENU), "DownloadIconFile"},
+};
+
+void patchIdbe() {
+    if (!cache_mutex_ready) {
+        OSInitMutex(&cache_mutex);
+        cache_mutex_ready = true;
+    }
+    hooks_install("IDBE", idbe_hooks);
+}
+
+void idbe_cache_process_start() {
+    opted_in = cache_mutex_ready && is_wii_u_menu(current_title().title_id) && sd_opted_in();
+    if (!opted_in) return;
+
+    OSLockMutex(&cache_mutex);
+    load_index();
+    OSUnlockMutex(&cache_mutex);
+}
+
+void idbe_cache_flush() {
+    if (!dirty || !cache_mutex_ready) return;
+
+    OSLockMutex(&cache_mutex);
+    dirty = false;
+    if (sd_opted_in()) {
+        FILE *file = fopen_unbuffered(IDBE_CACHE_INDEX, "wb");
+        const idbe_cache_header header = {IDBE_CACHE_MAGIC, entry_count};
+        if (!file || fwrite(&header, sizeof(header), 1, file) != 1 ||
+            fwrite(entries, sizeof(idbe_cache_entry), entry_count, file) != entry_count) {
+            DEBUG_FUNCTION_LINE("Inkay: failed to write the icon cache index");
+        }
+        if (file) fclose(file);
+    }
+    OSUnlockMutex(&cache_mutex);
+}
@@ -0,0 +1,26 @@
+/*  Copyright 2026 Pretendo Network contributors <pretendo.network>
+
+    Permission to use, copy, modify, and/or distribute this software for any purpose with or without fee is hereby
+    granted, provided that the above copyright notice and this permission notice appear in all copies.
+
+    THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES WITH REGARD TO THIS SOFTWARE INCLUDING ALL
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT,
+    INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER
+    IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR
+    PERFORMANCE OF THIS SOFTWARE.
+*/
+
+
+#pragma once
+
+/**
+ * Keeps the Wii U Menu's IDBE icon downloads on the SD card, so an icon only comes from the server once per title
+ * version (or once a week). Only used if fs:/vol/external01/wiiu/inkay/idbe/ exists when the Menu starts, and only
+ * on Pretendo.
+ */
+void patchIdbe();
+// checks the SD card and loads the index if this process is the Menu - call at every application start, after the
+// title context is refreshed
+void idbe_cache_process_start();
+// writes the cache index if anything changed since the last flush
+void idbe_cache_flush();
@@ -19,17 +19,22 @@
 #include "config.h"
 #include "olv_urls.h"
 #include "utils/logger.h"
+#include "utils/heap_walk.h"
+#include "utils/hook_registry.h"
+#include "utils/hook_stats.h"
 #include "utils/replace_mem.h"
+#include "utils/rootca_redirect.h"
 
-#include <vector>
-#include <optional>
+#include <atomic>
 #include <coreinit/debug.h>
 #include <coreinit/filesystem.h>
+#include <coreinit/memexpheap.h>
+#include <coreinit/memheap.h>
+#include <coreinit/thread.h>
+#include <coreinit/time.h>
 #include <nsysnet/nssl.h>
 #include <function_patcher/function_patching.h>
 
-#include "ca_pem.h" // generated at buildtime
-
 struct olv_allowlist {
     char scheme[16];
     char domain[128];
@@ -76,16 +81,110 @@ const replacement replacements[] = {
         {miiverse_green_touch2,    juxt_purple_touch2},
 };
 
-static std::optional<FSFileHandle> rootca_pem_handle{};
-std::vector<PatchedFunctionHandle> olv_patches;
+static RootCaRedirect rootca(TRACE_HOOK_OLV);
+
+// The Juxt recolor runs once per applet session, off the applet's file thread
+enum class recolor_state : uint32_t {
+    Idle,    ///< Not started this session
+    Running, ///< Background thread is waiting on or scanning the heap
+    Done,    ///< Finished for this session, never run again until the next initial.oma
+};
+static std::atomic<recolor_state> recolor_status = recolor_state::Idle;
+// set at APPLICATION_ENDS so the thread gives up instead of scanning a heap that's being torn down
+static std::atomic<bool> recolor_cancel = false;
+// joinable, so the process can't end with it still running
+static bool recolor_thread_started = false;
+
+// the colour tables are small, so don't bother with the big texture/sound buffers
+#define RECOLOR_MAX_BLOCK_SIZE 0x100000
+static mem_region recolor_regions[512];
+
+alignas(16) static uint8_t recolor_thread_stack[0x2000];
+alignas(8) static OSThread recolor_thread;
+
+// how long the heap has to stay unchanged before we consider the theme loaded
+#define RECOLOR_SETTLE_MS 50
+#define RECOLOR_MAX_WAIT_MS 3000
+
+// false if the applet is going away and we shouldn't scan at all
+static bool wait_for_heap_settled() {
+    MEMHeapHandle heap = MEMGetBaseHeapHandle(MEM_BASE_HEAP_MEM2);
+    if (!heap) return !recolor_cancel;
+
+    uint32_t last_free = MEMGetTotalFreeSizeForExpHeap(heap);
+    for (int waited = 0; waited < RECOLOR_MAX_WAIT_MS; waited += RECOLOR_SETTLE_MS) {
+        OSSleepTicks(OSMillisecondsToTicks(RECOLOR_SETTLE_MS));
+        if (recolor_cancel) return false;
+
+        uint32_t free = MEMGetTotalFreeSizeForExpHeap(heap);
+        if (free == last_free) return true;
+        last_free = free;
+    }
+    DEBUG_FUNCTION_LINE_VERBOSE("Inkay: heap still changing after %d ms, recoloring anyway", RECOLOR_MAX_WAIT_MS);
+    return !recolor_cancel;
+}
+
+static int recolor_thread_main(int argc, const char **argv) {
+    if (!wait_for_heap_settled()) {
+        DEBUG_FUNCTION_LINE_VERBOSE("Inkay: applet ended before the Juxt recolor ran");
+        recolor_status = recolor_state::Done;
+        return 0;
+    }
+
+    const auto start = OSGetSystemTick();
+    // they really are at Random Places In The Heap, so only look at what's actually allocated. the scans give up
+    // within a page of recolor_cancel being set, so APPLICATION_ENDS never waits out a whole pass
+    auto num_regions = collect_heap_regions(recolor_regions, 0, RECOLOR_MAX_BLOCK_SIZE);
+    auto replaced = replaceBulk(std::span(recolor_regions, num_regions), replacements, &recolor_cancel);
+    if (!replaced && !recolor_cancel) {
+        // the hardcoded offsets suck but they're what we had before
+        DEBUG_FUNCTION_LINE_VERBOSE("Inkay: nothing in the heap blocks, falling back to the old window");
+        replaced = replaceBulk(0x11000000, 0x02000000, replacements, &recolor_cancel);
+    }
+    const auto elapsed = OSGetSystemTick() - start;
+
+    DEBUG_FUNCTION_LINE("Inkay: Juxt recolor made %u replacements in %u ms", (unsigned) replaced,
+                        (unsigned) OSTicksToMilliseconds(elapsed));
+    recolor_status = recolor_state::Done;
+    return 0;
+}
+
+// waits for the last recolor thread, so its OSThread can be reused - quick unless it's still scanning
+static void join_recolor() {
+    if (!recolor_thread_started) return;
+
+    int ret;
+    OSJoinThread(&recolor_thread, &ret);
+    recolor_thread_started = false;
+}
+
+static void start_recolor() {
+    auto expected = recolor_state::Idle;
+    if (!recolor_status.compare_exchange_strong(expected, recolor_state::Running)) return;
+
+    // a session earlier in this process left its thread Done but unjoined - it's only a few instructions from exiting
+    join_recolor();
+    recolor_cancel = false;
+    if (!OSCreateThread(&recolor_thread, recolor_thread_main, 0, nullptr,
+                        recolor_thread_stack + sizeof(recolor_thread_stack), sizeof(recolor_thread_stack),
+                        24, OS_THREAD_ATTRIB_AFFINITY_ANY)) {
+        DEBUG_FUNCTION_LINE("Inkay: Failed to create Juxt recolor thread!");
+        recolor_status = recolor_state::Done;
+        return;
+    }
+    recolor_thread_started = true;
+    OSSetThreadName(&recolor_thread, "Inkay Juxt recolor");
+    OSResumeThread(&recolor_thread);
+}
 
 DECL_FUNCTION(int, FSOpenFile, FSClient *client, FSCmdBlock *block, char *path, const char *mode, uint32_t *handle,
               int error) {
+    HOOK_STATS_SCOPE(HOOK_OLV_FSOPENFILE);
     const char *initialOma = "vol/content/initial.oma";
 
     if (!Config::connect_to_network) {
         DEBUG_FUNCTION_LINE_VERBOSE("Inkay: Miiverse patches skipped.");
-        return real_FSOpenFile(client, block, path, mode, handle, error);
+        return HOOK_REAL(real_FSOpenFile, client, block, path, mode, handle, error);
     }
 
     if (strcmp(initialOma, path) == 0) {
@@ -95,66 +194,64 @@ DECL_FUNCTION(int, FSOpenFile, FSClient *client, FSCmdBlock *block, char *path,
 
         DEBUG_FUNCTION_LINE_VERBOSE("Inkay: hewwo!\n");
 
-        auto olv_ok = setup_olv_libs();
-        // Patch applet binary too
-        if (olv_ok)
-            replace(0x10000000, 0x10000000, (const char *)&original_entry, sizeof(original_entry), (const char *)&new_entry, sizeof(new_entry));
+        // new applet session, so the recolor may run again. whatever the last one's thread is doing is for a theme
+        // that's going away - it may even be between its last write and marking itself done
+        recolor_cancel = true;
+        join_recolor();
+        recolor_status = recolor_state::Idle;
+
+        // Patch applet binary too, in the same pass as the discovery URL
+        ScanQueue queue;
+        auto allowlist = queue.add(&original_entry, sizeof(original_entry), &new_entry, sizeof(new_entry));
+        auto olv_ok = setup_olv_libs(queue);
+        if (olv_ok && !queue.matches(allowlist))
+            DEBUG_FUNCTION_LINE_VERBOSE("Inkay: We didn't find the whitelist /)>~<(\\");
         // Check for root CA file and take note of its handle
-    } else if (strcmp("vol/content/browser/rootca.pem", path) == 0) {
-        int ret = real_FSOpenFile(client, block, path, mode, handle, error);
-        rootca_pem_handle = *handle;
-        DEBUG_FUNCTION_LINE_VERBOSE("Inkay: Found Miiverse CA, replacing...");
+    } else if (RootCaRedirect::is_rootca(path)) {
+        int ret = HOOK_REAL(real_FSOpenFile, client, block, path, mode, handle, error);
+        rootca.opened(ret, *handle);
         return ret;
     }
 
-    return real_FSOpenFile(client, block, path, mode, handle, error);
+    return HOOK_REAL(real_FSOpenFile, client, block, path, mode, handle, error);
 }
 
 DECL_FUNCTION(FSStatus, FSReadFile, FSClient *client, FSCmdBlock *block, uint8_t *buffer, uint32_t size, uint32_t count,
               FSFileHandle handle, uint32_t unk1, uint32_t flags) {
-    if (size != 1) {
-        DEBUG_FUNCTION_LINE("Inkay: Miiverse CA replacement failed!");
-    }
-
-    if (rootca_pem_handle && *rootca_pem_handle == handle) {
-        strlcpy((char *) buffer, (const char *) ca_pem, size * count);
-
+    HOOK_STATS_SCOPE(HOOK_OLV_FSREADFILE);
+    if (rootca.read(handle, buffer, size, count)) {
         //this can't be done above (in the FSOpenFile hook) since it's not loaded yet.
-        //the hardcoded offsets suck but they really are at Random Places In The Heap
-        replaceBulk(0x11000000, 0x02000000, replacements);
+        start_recolor();
         return (FSStatus) count;
     }
 
-    return real_FSReadFile(client, block, buffer, size, count, handle, unk1, flags);
+    return HOOK_REAL(real_FSReadFile, client, block, buffer, size, count, handle, unk1, flags);
 }
 
 DECL_FUNCTION(FSStatus, FSCloseFile, FSClient *client, FSCmdBlock *block, FSFileHandle handle, FSErrorFlag errorMask) {
-    if (handle == rootca_pem_handle) {
-        rootca_pem_handle.reset();
-    }
+    HOOK_STATS_SCOPE(HOOK_OLV_FSCLOSEFILE);
+    rootca.closed(handle);
 
-    return real_FSCloseFile(client, block, handle, errorMask);
+    return HOOK_REAL(real_FSCloseFile, client, block, handle, errorMask);
 }
 
+static const hook_def olv_hooks[] = {
+        {REPLACE_FUNCTION_FOR_PROCESS(FSOpenFile, LIBRARY_COREINIT, FSOpenFile, FP_TARGET_PROCESS_MIIVERSE), "FSOpenFile"},
+        {REPLACE_FUNCTION_FOR_PROCESS(FSReadFile, LIBRARY_COREINIT, FSReadFile, FP_TARGET_PROCESS_MIIVERSE), "FSReadFile"},
+        {REPLACE_FUNCTION_FOR_PROCESS(FSCloseFile, LIBRARY_COREINIT, FSCloseFile, FP_TARGET_PROCESS_MIIVERSE), "FSCloseFile"},
+};
+
 void patchOlvApplet() {
-    olv_patches.reserve(3);
-
-    auto add_patch = [](function_replacement_data_t repl, const char *name) {
-        PatchedFunctionHandle handle = 0;
-        if (FunctionPatcher_AddFunctionPatch(&repl, &handle, nullptr) != FUNCTION_PATCHER_RESULT_SUCCESS) {
-            DEBUG_FUNCTION_LINE("Inkay/OLV: Failed to patch %s!", name);
-        }
-        olv_patches.push_back(handle);
-    };
-
-    add_patch(REPLACE_FUNCTION_FOR_PROCESS(FSOpenFile, LIBRARY_COREINIT, FSOpenFile, FP_TARGET_PROCESS_MIIVERSE), "FSOpenFile");
-    add_patch(REPLACE_FUNCTION_FOR_PROCESS(FSReadFile, LIBRARY_COREINIT, FSReadFile, FP_TARGET_PROCESS_MIIVERSE), "FSReadFile");
-    add_patch(REPLACE_FUNCTION_FOR_PROCESS(FSCloseFile, LIBRARY_COREINIT, FSCloseFile, FP_TARGET_PROCESS_MIIVERSE), "FSCloseFile");
+    hooks_install("OLV", olv_hooks);
 }
 
-void unpatchOlvApplet() {
-    for (auto handle: olv_patches) {
-        FunctionPatcher_RemoveFunctionPatch(handle);
-    }
-    olv_patches.clear();
+void olv_applet_process_start() {
+    recolor_status = recolor_state::Idle;
+}
+
+void olv_applet_process_end() {
+    // at most one settle interval if it's still waiting, or a page of the scan
+    recolor_cancel = true;
+    join_recolor();
+    recolor_status = recolor_state::Idle;
 }
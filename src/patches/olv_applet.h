@@ -17,4 +17,7 @@
 #pragma once
 
 void patchOlvApplet();
-void unpatchOlvApplet();
+
+// the Juxt recolor is per applet process - these reset it and make sure its thread is gone before the process is
+void olv_applet_process_start();
+void olv_applet_process_end();
@@ -19,63 +19,96 @@
 #include "config.h"
 #include "olv_urls.h"
 #include "utils/logger.h"
+#include "utils/heap_walk.h"
+#include "utils/patch_txn.h"
 #include "utils/replace_mem.h"
+#include "utils/rpl_info.h"
+#include "utils/title_cache.h"
 
+#include <algorithm>
 #include <cstring>
-#include <coreinit/dynload.h>
 #include <coreinit/memory.h>
 
-bool check_olv_libs() {
-    OSDynLoad_Module olv_handle = 0;
-    OSDynLoad_Error dret;
-
-    dret = OSDynLoad_IsModuleLoaded("nn_olv", &olv_handle);
-    if (dret == OS_DYNLOAD_OK && olv_handle != 0) {
-        return true;
-    }
+// set once nn_olv's copy of the URL has been patched in this process, cleared again at every APPLICATION_STARTS
+static bool olv_url_patched = false;
 
-    dret = OSDynLoad_IsModuleLoaded("nn_olv2", &olv_handle);
-    if (dret == OS_DYNLOAD_OK && olv_handle != 0) {
-        return true;
-    }
-
-    return false;
+bool check_olv_libs() {
+    return search_for_rpl("nn_olv.rpl") || search_for_rpl("nn_olv2.rpl");
 }
 
-#define OLV_RPL "nn_olv.rpl"
-bool path_is_olv(const char* path) {
-    auto path_len = strlen(path);
-    auto* path_suffix = path + path_len - (sizeof(OLV_RPL) - 1); //1 for null
-    return strcmp(path_suffix, OLV_RPL) == 0;
-}
+static void olv_rpl_changed(const OSDynLoad_NotifyData &rpl, OSDynLoad_NotifyReason reason) {
+    if (reason != OS_DYNLOAD_NOTIFY_LOADED) {
+        olv_url_patched = false;
+        return;
+    }
 
-void new_rpl_loaded(OSDynLoad_Module module, void* ctx, OSDynLoad_NotifyReason reason, OSDynLoad_NotifyData* rpl) {
     if (!Config::connect_to_network) {
         DEBUG_FUNCTION_LINE_VERBOSE("Inkay: Miiverse patches skipped.");
         return;
     }
 
-    // Loaded olv?
-    if (reason != OS_DYNLOAD_NOTIFY_LOADED) return;
-    if (!rpl->name || !path_is_olv(rpl->name)) return;
+    const auto &title = current_title();
+
+    // last launch told us where the URL is, check there before scanning the whole section
+    const auto *cached = title_cache_find(title);
+    if (cached && (cached->flags & TITLE_CACHE_OLV_OFFSET) &&
+        (uint64_t) cached->olv_offset + sizeof(original_url) <= rpl.dataSize) {
+        PatchTransaction txn;
+        txn.replace(rpl.dataAddr + cached->olv_offset, sizeof(original_url), original_url, sizeof(original_url),
+                    new_url, sizeof(new_url));
+        olv_url_patched = txn.commit();
+        if (olv_url_patched) return;
+    }
 
-    replace(rpl->dataAddr, rpl->dataSize, original_url, sizeof(original_url), new_url, sizeof(new_url));
+    // journalled, so switching networks can put nn_olv back the way it was
+    PatchTransaction txn;
+    ScanQueue queue(&txn);
+    const auto url = queue.add(original_url, sizeof(original_url), new_url, sizeof(new_url));
+    queue.run(rpl.dataAddr, rpl.dataSize);
+    olv_url_patched = queue.matches(url) > 0 && txn.commit();
+
+    if (olv_url_patched) {
+        title_cache_set(title, TITLE_CACHE_OLV_OFFSET, queue.first_match(url) - rpl.dataAddr);
+    } else {
+        title_cache_clear(title, TITLE_CACHE_OLV_OFFSET);
+    }
 }
 
-bool setup_olv_libs() {
+void install_olv_url_patches() {
+    // the callback checks Config::connect_to_network itself, so one subscription covers network switches too
+    static bool subscribed = false;
+    if (!subscribed) subscribed = rpl_subscribe("nn_olv.rpl", &olv_rpl_changed);
+}
+
+void olv_url_reverted() {
+    olv_url_patched = false;
+}
+
+static mem_region olv_regions[512];
+
+bool setup_olv_libs(ScanQueue &queue) {
     if (!Config::connect_to_network) {
         DEBUG_FUNCTION_LINE_VERBOSE("Inkay: Miiverse patches skipped.");
         return false;
     }
 
-    OSDynLoad_AddNotifyCallback(&new_rpl_loaded, nullptr);
-
     auto olvLoaded = check_olv_libs();
     if (!olvLoaded) {
         DEBUG_FUNCTION_LINE_VERBOSE("Inkay: no olv, quitting for now\n");
         return false;
     }
 
+    // usually already done when nn_olv loaded, but the applet can still have things for us to do
+    auto url = ScanQueue::capacity;
+    if (!olv_url_patched)
+        url = queue.add(original_url, sizeof(original_url), new_url, sizeof(new_url));
+    if (queue.done()) return true;
+
+    // the URL lives in nn_olv's data section, so live memory should find it without touching the rest of MEM2
+    queue.run(std::span(olv_regions, collect_process_regions(olv_regions)));
+    olv_url_patched |= queue.matches(url) > 0;
+    if (queue.done()) return olv_url_patched;
+
     //wish there was a better way than "blow through MEM2"
     uint32_t base_addr, size;
     if (OSGetMemBound(OS_MEM2, &base_addr, &size)) {
@@ -83,5 +116,19 @@ bool setup_olv_libs() {
         return false;
     }
 
-    return replace(base_addr, size, original_url, sizeof(original_url), new_url, sizeof(new_url));
+    // callers might have queued things from the applet binary too, so cover that as well
+    const uint32_t start = std::min<uint32_t>(base_addr, 0x10000000);
+    const uint32_t end = std::max<uint32_t>(base_addr + size, 0x20000000);
+    queue.run(start, end - start);
+#ifdef DEBUG
+    log_scan_stats("Miiverse", queue.stats());
+#endif
+
+    olv_url_patched |= queue.matches(url) > 0;
+    return olv_url_patched;
+}
+
+bool setup_olv_libs() {
+    ScanQueue queue;
+    return setup_olv_libs(queue);
 }
@@ -16,6 +16,7 @@
 
 #include <cstdlib>
 #include "inkay_config.h"
+#include "utils/replace_mem.h"
 
 constexpr char original_url[] = "discovery.olv.nintendo.net/v1/endpoint";
 constexpr char new_url[] =      "discovery.olv." NETWORK_BASEURL "/v1/endpoint";
@@ -23,4 +24,14 @@ constexpr char new_url[] =      "discovery.olv." NETWORK_BASEURL "/v1/endpoint";
 _Static_assert(sizeof(original_url) > sizeof(new_url),
                "new_url too long! Must be less than 38chars.");
 
+// watches for nn_olv loading and patches it straight away
+void install_olv_url_patches();
+// nn_olv's URL got rolled back (network switch) or its process went away, so the next setup_olv_libs() has to
+// patch it again
+void olv_url_reverted();
+
+// true if nn_olv is loaded in the running process
+bool check_olv_libs();
 bool setup_olv_libs();
+// as above, but anything already in queue gets patched in the same pass over memory
+bool setup_olv_libs(ScanQueue &queue);
@@ -0,0 +1,157 @@
+/*  Copyright 2026 Pretendo Network contributors <pretendo.network>
+
+    Permission to use, copy, modify, and/or distribute this software for any purpose with or without fee is hereby
+    granted, provided that the above copyright notice and this permission notice appear in all copies.
+
+    THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES WITH REGARD TO THIS SOFTWARE INCLUDING ALL
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT,
+    INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER
+    IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR
+    PERFORMANCE OF THIS SOFTWARE.
+*/
+
+
+#include "patch_pack.h"
+
+#include "config.h"
+#include "sysconfig.h"
+#include "utils/logger.h"
+#include "utils/patch_txn.h"
+#include "utils/replace_mem.h"
+#include "utils/sd_file.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <span>
+
+#define PATCH_PACK_PATH "fs:/vol/external01/wiiu/inkay/patches.bin"
+// records are a few dozen bytes each, this is plenty
+#define PATCH_PACK_MAX_SIZE 0x8000
+// longest record we'll patch the port into - a u16 or an instruction
+#define PATCH_PACK_MAX_PORT_LEN 4
+
+alignas(8) static uint8_t pack_data[PATCH_PACK_MAX_SIZE];
+static std::span<const patch_pack_title> pack_titles;
+static uint32_t pack_size = 0;
+static bool pack_loaded = false;
+
+void patch_pack_load() {
+    if (pack_loaded) return;
+    pack_loaded = true;
+
+    const auto size = read_whole_file(PATCH_PACK_PATH, pack_data);
+    if (!size) return;
+    pack_size = *size;
+
+    const auto *header = (const patch_pack_header *) pack_data;
+    if (pack_size < sizeof(*header) || header->magic != PATCH_PACK_MAGIC ||
+        header->format != PATCH_PACK_FORMAT ||
+        sizeof(*header) + header->title_count * sizeof(patch_pack_title) > pack_size) {
+        DEBUG_FUNCTION_LINE("Inkay: ignoring invalid patch pack");
+        pack_size = 0;
+        return;
+    }
+
+    const auto titles = std::span((const patch_pack_title *) (pack_data + sizeof(*header)), header->title_count);
+    // run_patch_pack binary searches the titles, and reads the records in place as u32s
+    auto key = [](const patch_pack_title &entry) { return std::pair(entry.title_id, entry.version); };
+    const bool sorted = std::ranges::adjacent_find(titles, std::ranges::greater_equal(), key) == titles.end();
+    const bool aligned = std::ranges::all_of(titles, [](const patch_pack_title &entry) {
+        return entry.records_offset % alignof(patch_pack_record) == 0;
+    });
+    if (!sorted || !aligned) {
+        DEBUG_FUNCTION_LINE("Inkay: ignoring patch pack with %s titles", !sorted ? "unsorted" : "misaligned");
+        pack_size = 0;
+        return;
+    }
+
+    pack_titles = titles;
+    DEBUG_FUNCTION_LINE_VERBOSE("Inkay: patch pack has %d titles", header->title_count);
+}
+
+// true if [start, start + len) is inside one of the main executable's sections
+static bool in_rpx(const title_context &title, uint32_t start, uint32_t len) {
+    auto inside = [start, len](const mem_region &region) {
+        return start >= region.start && (uint64_t) start + len <= (uint64_t) region.start + region.size;
+    };
+    return inside(title.text) || inside(title.data) || inside(title.read);
+}
+
+static bool apply_record(const title_context &title, const patch_pack_record &record, const uint8_t *expected,
+                         const uint8_t *replacement) {
+    uint8_t with_port[PATCH_PACK_MAX_PORT_LEN];
+    if (record.flags & PATCH_PACK_P2P_PORT) {
+        if (record.length < 2 || record.length > sizeof(with_port)) return false;
+
+        const auto port = get_console_peertopeer_port();
+        memcpy(with_port, replacement, record.length);
+        with_port[record.length - 2] |= port >> 8;
+        with_port[record.length - 1] |= port & 0xFF;
+        replacement = with_port;
+    }
+
+    const bool code = record.flags & PATCH_PACK_CODE;
+    const auto repl = std::span(replacement, record.length);
+
+    PatchTransaction txn;
+    if (record.kind == PATCH_PACK_ADDRESS) {
+        const auto target = (uint32_t) (uintptr_t) rpx_addr(title, record.address);
+        if (!in_rpx(title, target, record.length) ||
+            memcmp((void *) (uintptr_t) target, expected, record.length) != 0) {
+            return false;
+        }
+        txn.stage(target, repl, code);
+    } else if (record.kind == PATCH_PACK_SIGNATURE) {
+        // only looking - the real transaction needs to know if it's code
+        PatchTransaction probe;
+        ScanQueue queue(&probe);
+        const auto sig = queue.add(expected, record.length, replacement, record.length);
+        const mem_region regions[] = {title.text, title.data, title.read};
+        queue.run(regions);
+
+        const auto target = queue.first_match(sig);
+        if (!target) return false;
+        txn.stage(target, repl, code);
+    } else {
+        return false;
+    }
+
+    return txn.commit();
+}
+
+int run_patch_pack(const title_context &title) {
+    if (!Config::connect_to_network || pack_titles.empty() || !title.version || !title.has_rpx()) {
+        return 0;
+    }
+
+    auto key = [](const patch_pack_title &entry) { return std::pair(entry.title_id, entry.version); };
+    const auto entry = std::ranges::lower_bound(pack_titles, std::pair(title.title_id, *title.version), {}, key);
+    if (entry == pack_titles.end() || entry->title_id != title.title_id || entry->version != *title.version) {
+        return 0;
+    }
+
+    int applied = 0;
+    uint32_t offset = entry->records_offset;
+    for (int i = 0; i < entry->record_count; i++) {
+        if ((uint64_t) offset + sizeof(patch_pack_record) > pack_size) break;
+        const auto &record = *(const patch_pack_record *) (pack_data + offset);
+        offset += sizeof(record);
+
+        const uint32_t data_len = ((uint32_t) record.length * 2 + 3) & ~3u;
+        if (record.length == 0 || (uint64_t) offset + data_len > pack_size) break;
+        const uint8_t *expected = pack_data + offset;
+        const uint8_t *replacement = expected + record.length;
+        offset += data_len;
+
+        if (apply_record(title, record, expected, replacement)) {
+            applied++;
+        } else {
+            DEBUG_FUNCTION_LINE("Inkay: patch pack record %d for %016llX didn't apply", i,
+                                (unsigned long long) title.title_id);
+        }
+    }
+
+    DEBUG_FUNCTION_LINE_VERBOSE("Inkay: applied %d/%d patch pack records", applied, entry->record_count);
+    return applied;
+}
@@ -0,0 +1,68 @@
+/*  Copyright 2026 Pretendo Network contributors <pretendo.network>
+
+    Permission to use, copy, modify, and/or distribute this software for any purpose with or without fee is hereby
+    granted, provided that the above copyright notice and this permission notice appear in all copies.
+
+    THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES WITH REGARD TO THIS SOFTWARE INCLUDING ALL
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT,
+    INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER
+    IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR
+    PERFORMANCE OF THIS SOFTWARE.
+*/
+
+
+#pragma once
+
+#include "utils/title_context.h"
+
+#include <cstdint>
+
+/**
+ * Patch packs let per-title patches ship as data on the SD card instead of in the module. The pack is one big-endian
+ * file (the console's byte order, so it's used straight from the buffer):
+ *
+ *   patch_pack_header
+ *   patch_pack_title[title_count]      sorted by title ID, then version, no duplicates
+ *   records                            per title, each a patch_pack_record followed by `length` expected bytes and
+ *                                      `length` replacement bytes, padded to 4
+ *
+ * Offsets are from the start of the file, and records_offset must be a multiple of 4. A pack that breaks either rule
+ * is ignored as a whole.
+ */
+#define PATCH_PACK_MAGIC 0x494B504B // IKPK
+#define PATCH_PACK_FORMAT 1
+
+struct patch_pack_header {
+    uint32_t magic;
+    uint16_t format;
+    uint16_t title_count;
+};
+
+struct patch_pack_title {
+    uint64_t title_id;
+    uint16_t version;
+    uint16_t record_count;
+    uint32_t records_offset;
+};
+
+enum patch_pack_kind : uint8_t {
+    PATCH_PACK_ADDRESS = 0,   ///< address is a Cemu-style address in the main executable (see rpx_addr)
+    PATCH_PACK_SIGNATURE = 1, ///< search the main executable for the expected bytes
+};
+
+enum patch_pack_flags : uint8_t {
+    PATCH_PACK_CODE = 1 << 0,     ///< invalidate the instruction cache afterwards
+    PATCH_PACK_P2P_PORT = 1 << 1, ///< OR the console's P2P port into the last two replacement bytes
+};
+
+struct patch_pack_record {
+    uint8_t kind;
+    uint8_t flags;
+    uint16_t length;
+    uint32_t address;
+};
+
+// reads fs:/vol/external01/wiiu/inkay/patches.bin, once per session - missing is fine
+void patch_pack_load();
+// applies the pack's records for this title and version, returns how many applied
+int run_patch_pack(const title_context &title);
@@ -0,0 +1,65 @@
+/*  Copyright 2026 Pretendo Network contributors <pretendo.network>
+
+    Permission to use, copy, modify, and/or distribute this software for any purpose with or without fee is hereby
+    granted, provided that the above copyright notice and this permission notice appear in all copies.
+
+    THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES WITH REGARD TO THIS SOFTWARE INCLUDING ALL
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT,
+    INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER
+    IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR
+    PERFORMANCE OF THIS SOFTWARE.
+*/
+
+#include "title_patches.h"
+
+#include "config.h"
+#include "account_settings.h"
+#include "game_peertopeer.h"
+#include "utils/logger.h"
+
+#include <algorithm>
+
+static void account_settings_patch(const title_context &title) {
+    hotpatchAccountSettings(title);
+}
+
+// keep this sorted by title ID! the static_assert below will complain otherwise
+static constexpr title_patch title_patches[] = {
+        // Mario Kart 8 (JPN, USA, EUR)
+        {0x00050000'1010EB00, 81,                      mk8_peertopeer_patch,       "MK8 P2P port"},
+        {0x00050000'1010EC00, 81,                      mk8_peertopeer_patch,       "MK8 P2P port"},
+        {0x00050000'1010ED00, 81,                      mk8_peertopeer_patch,       "MK8 P2P port"},
+        // Splatoon (JPN, USA, EUR)
+        {0x00050000'10162B00, 288,                     splatoon_peertopeer_patch,  "Splatoon P2P port"},
+        {0x00050000'10176900, 288,                     splatoon_peertopeer_patch,  "Splatoon P2P port"},
+        {0x00050000'10176A00, 288,                     splatoon_peertopeer_patch,  "Splatoon P2P port"},
+        // Minecraft: Wii U Edition (EUR, USA, JPN)
+        {0x00050000'101D7500, 688,                     minecraft_peertopeer_patch, "Minecraft P2P port"},
+        {0x00050000'101D9D00, 688,                     minecraft_peertopeer_patch, "Minecraft P2P port"},
+        {0x00050000'101DBE00, 688,                     minecraft_peertopeer_patch, "Minecraft P2P port"},
+        // Account Settings (JPN, USA, EUR)
+        {0x00050010'1004B000, TITLE_PATCH_ANY_VERSION, account_settings_patch,     "Account Settings"},
+        {0x00050010'1004B100, TITLE_PATCH_ANY_VERSION, account_settings_patch,     "Account Settings"},
+        {0x00050010'1004B200, TITLE_PATCH_ANY_VERSION, account_settings_patch,     "Account Settings"},
+};
+static_assert(std::ranges::is_sorted(title_patches, {}, &title_patch::title_id),
+              "title_patches must be sorted by title ID");
+
+int run_title_patches(const title_context &title) {
+    if (!Config::connect_to_network) {
+        return 0;
+    }
+
+    auto [first, last] = std::ranges::equal_range(title_patches, title.title_id, {}, &title_patch::title_id);
+
+    int ran = 0;
+    for (const auto &patch: std::ranges::subrange(first, last)) {
+        if (patch.version != TITLE_PATCH_ANY_VERSION && title.version != patch.version) continue;
+
+        DEBUG_FUNCTION_LINE_VERBOSE("Applying %s", patch.name);
+        patch.apply(title);
+        ran++;
+    }
+
+    return ran;
+}
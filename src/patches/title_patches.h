@@ -0,0 +1,32 @@
+/*  Copyright 2026 Pretendo Network contributors <pretendo.network>
+
+    Permission to use, copy, modify, and/or distribute this software for any purpose with or without fee is hereby
+    granted, provided that the above copyright notice and this permission notice appear in all copies.
+
+    THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES WITH REGARD TO THIS SOFTWARE INCLUDING ALL
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT,
+    INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER
+    IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR
+    PERFORMANCE OF THIS SOFTWARE.
+*/
+
+#pragma once
+
+#include "utils/title_context.h"
+
+#include <cstdint>
+
+#define TITLE_PATCH_ANY_VERSION 0xFFFF
+
+using title_patch_fn = void (*)(const title_context &title);
+
+struct title_patch {
+    uint64_t title_id;
+    uint16_t version; ///< TITLE_PATCH_ANY_VERSION to run on every version
+    title_patch_fn apply;
+    const char *name;
+};
+
+// runs every registered patch for the title - one binary search, nothing for titles we don't know about
+// returns the number of patches that ran
+int run_title_patches(const title_context &title);
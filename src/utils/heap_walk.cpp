@@ -0,0 +1,145 @@
+/*  Copyright 2026 Pretendo Network contributors <pretendo.network>
+
+    Permission to use, copy, modify, and/or distribute this software for any purpose with or without fee is hereby
+    granted, provided that the above copyright notice and this permission notice appear in all copies.
+
+    THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES WITH REGARD TO THIS SOFTWARE INCLUDING ALL
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT,
+    INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER
+    IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR
+    PERFORMANCE OF THIS SOFTWARE.
+*/
+
+#include "heap_walk.h"
+#include "logger.h"
+#include "rpl_info.h"
+
+#include <coreinit/memheap.h>
+#include <coreinit/memexpheap.h>
+#include <coreinit/memfrmheap.h>
+#include <coreinit/memlist.h>
+#include <coreinit/spinlock.h>
+
+#include <algorithm>
+
+// blocks closer together than this (i.e. just a block header apart) get merged into one region
+#define HEAP_MERGE_GAP 0x40
+#define HEAP_MAX_CHILDREN 16
+#define HEAP_MAX_DEPTH 4
+
+struct region_collector {
+    std::span<mem_region> out;
+    size_t count;
+    uint32_t min_block_size;
+    uint32_t max_block_size;
+    bool truncated; ///< ran out of room in out - what's there is only part of the heap
+};
+
+static void add_region(region_collector &c, uint32_t start, uint32_t size) {
+    if (!size || c.truncated) return;
+
+    if (c.count > 0) {
+        auto &last = c.out[c.count - 1];
+        const uint32_t last_end = last.start + last.size;
+        // merge with the previous block, if it's just a header away
+        if (start >= last.start && start <= last_end + HEAP_MERGE_GAP) {
+            const uint32_t end = std::max(last_end, start + size);
+            last.start = std::min(last.start, start);
+            last.size = end - last.start;
+            return;
+        }
+    }
+
+    // growing the last region would drag in free space and other heaps, so just give up
+    if (c.count == c.out.size()) {
+        c.truncated = true;
+        return;
+    }
+    c.out[c.count++] = {start, size};
+}
+
+static bool block_holds_child(uint32_t start, uint32_t size, std::span<MEMHeapHeader *const> children) {
+    for (auto *child: children) {
+        if ((uint32_t) (uintptr_t) child >= start && (uint32_t) (uintptr_t) child < start + size) return true;
+    }
+    return false;
+}
+
+static void walk_heap(region_collector &c, MEMHeapHeader *heap, int depth) {
+    if (!heap || depth > HEAP_MAX_DEPTH || c.truncated) return;
+
+    const bool locked = heap->flags & MEM_HEAP_FLAG_USE_LOCK;
+    if (locked) OSUninterruptibleSpinLock_Acquire(&heap->lock);
+
+    // heaps created inside this one show up as allocated blocks - skip those and walk the child heap instead
+    MEMHeapHeader *children[HEAP_MAX_CHILDREN];
+    size_t num_children = 0;
+    for (void *child = MEMGetNextListObject(&heap->list, nullptr); child && num_children < HEAP_MAX_CHILDREN;
+         child = MEMGetNextListObject(&heap->list, child)) {
+        children[num_children++] = (MEMHeapHeader *) child;
+    }
+    std::span<MEMHeapHeader *const> child_span(children, num_children);
+
+    switch (heap->tag) {
+        case MEM_EXPANDED_HEAP_TAG: {
+            auto *exp = (MEMExpHeap *) heap;
+            for (auto *block = exp->usedList.head; block && !c.truncated; block = block->next) {
+                const uint32_t start = (uint32_t) (uintptr_t) block + sizeof(MEMExpHeapBlock);
+                const uint32_t size = block->blockSize;
+                if (size < c.min_block_size || size > c.max_block_size) continue;
+                if (block_holds_child(start, size, child_span)) continue;
+
+                add_region(c, start, size);
+            }
+            break;
+        }
+        case MEM_FRAME_HEAP_TAG: {
+            auto *frm = (MEMFrmHeap *) heap;
+            const auto data_start = (uint32_t) (uintptr_t) heap->dataStart;
+            const auto data_end = (uint32_t) (uintptr_t) heap->dataEnd;
+            // frame heaps allocate from both ends; the middle is free
+            add_region(c, data_start, (uint32_t) (uintptr_t) frm->head - data_start);
+            add_region(c, (uint32_t) (uintptr_t) frm->tail, data_end - (uint32_t) (uintptr_t) frm->tail);
+            break;
+        }
+        default: {
+            // unit/block/user heaps - don't know the layout, so report the whole thing
+            const auto data_start = (uint32_t) (uintptr_t) heap->dataStart;
+            add_region(c, data_start, (uint32_t) (uintptr_t) heap->dataEnd - data_start);
+            break;
+        }
+    }
+
+    if (locked) OSUninterruptibleSpinLock_Release(&heap->lock);
+
+    for (auto *child: child_span) {
+        walk_heap(c, child, depth + 1);
+    }
+}
+
+size_t collect_heap_regions(std::span<mem_region> out, uint32_t min_block_size, uint32_t max_block_size) {
+    region_collector c = {
+            .out = out,
+            .count = 0,
+            .min_block_size = min_block_size,
+            .max_block_size = max_block_size,
+            .truncated = false,
+    };
+
+    for (auto arena: {MEM_BASE_HEAP_MEM1, MEM_BASE_HEAP_MEM2, MEM_BASE_HEAP_FG}) {
+        walk_heap(c, MEMGetBaseHeapHandle(arena), 0);
+    }
+
+    if (c.truncated) {
+        DEBUG_FUNCTION_LINE("Inkay: more than %d heap regions, not using the heap walk", (int) out.size());
+        return 0;
+    }
+
+    DEBUG_FUNCTION_LINE_VERBOSE("Collected %d heap regions", c.count);
+    return c.count;
+}
+
+size_t collect_process_regions(std::span<mem_region> out) {
+    size_t count = collect_rpl_regions(out);
+    return count + collect_heap_regions(out.subspan(count));
+}
@@ -0,0 +1,40 @@
+/*  Copyright 2026 Pretendo Network contributors <pretendo.network>
+
+    Permission to use, copy, modify, and/or distribute this software for any purpose with or without fee is hereby
+    granted, provided that the above copyright notice and this permission notice appear in all copies.
+
+    THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES WITH REGARD TO THIS SOFTWARE INCLUDING ALL
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT,
+    INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER
+    IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR
+    PERFORMANCE OF THIS SOFTWARE.
+*/
+
+#pragma once
+
+#include "replace_mem.h"
+
+#include <cstdint>
+#include <cstddef>
+#include <span>
+
+/**
+ * Snapshots the allocated blocks of the current process' MEM1, MEM2 and foreground heaps (and any heaps created
+ * inside them) into out. Free space is never reported. Expanded heap blocks outside [min_block_size, max_block_size]
+ * are skipped; frame heaps are always reported whole.
+ *
+ * Neighbouring blocks are merged. If there are still more regions than fit in out, the walk stops and nothing is
+ * reported, since a partial list could miss the block a caller is after - fall back to scanning an explicit window.
+ *
+ * @return the number of regions written to out, or 0 if out was too small
+ */
+size_t collect_heap_regions(std::span<mem_region> out, uint32_t min_block_size = 0,
+                            uint32_t max_block_size = UINT32_MAX);
+
+/**
+ * Collects every region of the current process a patch target could plausibly live in: the data sections of the
+ * loaded RPLs, then the allocated heap blocks. The heap blocks are left out if they don't all fit.
+ *
+ * @return the number of regions written to out
+ */
+size_t collect_process_regions(std::span<mem_region> out);
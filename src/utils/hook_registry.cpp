@@ -0,0 +1,66 @@
+/*  Copyright 2026 Pretendo Network contributors <pretendo.network>
+
+    Permission to use, copy, modify, and/or distribute this software for any purpose with or without fee is hereby
+    granted, provided that the above copyright notice and this permission notice appear in all copies.
+
+    THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES WITH REGARD TO THIS SOFTWARE INCLUDING ALL
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT,
+    INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER
+    IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR
+    PERFORMANCE OF THIS SOFTWARE.
+*/
+
+
+#include "hook_registry.h"
+#include "logger.h"
+#include "ipc_stats.h"
+
+#include <cstring>
+
+// DNS, eShop, Miiverse, Account Settings, NEX matchmaking - with room to grow
+#define HOOK_REGISTRY_CAPACITY 32
+
+static hook_status hooks[HOOK_REGISTRY_CAPACITY];
+static uint32_t hook_count = 0;
+
+static bool group_installed(const char *group) {
+    for (uint32_t i = 0; i < hook_count; i++) {
+        if (strcmp(hooks[i].group, group) == 0) return true;
+    }
+    return false;
+}
+
+bool hooks_install(const char *group, std::span<const hook_def> defs) {
+    if (group_installed(group)) return true;
+
+    if (hook_count + defs.size() > HOOK_REGISTRY_CAPACITY) {
+        DEBUG_FUNCTION_LINE("Inkay/%s: Hook registry full!", group);
+        return false;
+    }
+
+    bool ok = true;
+    for (const auto &def: defs) {
+        auto repl = def.repl;
+        auto &hook = hooks[hook_count++];
+        hook = {group, def.name, 0, false};
+
+        hook.installed = IPC_CALL(IPC_FUNCTION_PATCHER, FunctionPatcher_AddFunctionPatch(&repl, &hook.handle, nullptr)) ==
+                         FUNCTION_PATCHER_RESULT_SUCCESS;
+        if (!hook.installed) {
+            DEBUG_FUNCTION_LINE("Inkay/%s: Failed to patch %s!", group, def.name);
+            ok = false;
+        }
+    }
+    return ok;
+}
+
+void hooks_remove_all() {
+    for (uint32_t i = hook_count; i > 0; i--) {
+        if (hooks[i - 1].installed) FunctionPatcher_RemoveFunctionPatch(hooks[i - 1].handle);
+    }
+    hook_count = 0;
+}
+
+std::span<const hook_status> hooks_status() {
+    return std::span(hooks, hook_count);
+}
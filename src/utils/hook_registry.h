@@ -0,0 +1,42 @@
+/*  Copyright 2026 Pretendo Network contributors <pretendo.network>
+
+    Permission to use, copy, modify, and/or distribute this software for any purpose with or without fee is hereby
+    granted, provided that the above copyright notice and this permission notice appear in all copies.
+
+    THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES WITH REGARD TO THIS SOFTWARE INCLUDING ALL
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT,
+    INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER
+    IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR
+    PERFORMANCE OF THIS SOFTWARE.
+*/
+
+
+#pragma once
+
+#include <function_patcher/function_patching.h>
+
+#include <cstdint>
+#include <span>
+
+struct hook_def {
+    function_replacement_data_t repl;
+    const char *name;
+};
+
+struct hook_status {
+    const char *group; ///< the module that owns it, e.g. "DNS"
+    const char *name;
+    PatchedFunctionHandle handle;
+    bool installed;    ///< false if FunctionPatcher refused it
+};
+
+/**
+ * Every FunctionPatcher hook Inkay installs, in one fixed table. Modules declare their hooks as a static hook_def
+ * array and hand it over here; removal is one pass over the table.
+ */
+// installs every hook in the group, returns false if any of them failed. Installing a group twice does nothing.
+bool hooks_install(const char *group, std::span<const hook_def> hooks);
+void hooks_remove_all();
+
+// what's hooked right now, in install order - failed hooks are included so they can be reported
+std::span<const hook_status> hooks_status();
@@ -0,0 +1,204 @@
+/*  Copyright 2026 Pretendo Network contributors <pretendo.network>
+
+    Permission to use, copy, modify, and/or distribute this software for any purpose with or without fee is hereby
+    granted, provided that the above copyright notice and this permission notice appear in all copies.
+
+    THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES WITH REGARD TO THIS SOFTWARE INCLUDING ALL
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT,
+    INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER
+    IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR
+    PERFORMANCE OF THIS SOFTWARE.
+*/
+
+
+#include "hook_stats.h"
+#include "logger.h"
+
+#ifdef HOOK_STATS
+
+#include <coreinit/core.h>
+#include <coreinit/interrupts.h>
+#include <coreinit/memdefaultheap.h>
+#include <coreinit/thread.h>
+
+#include <atomic>
+#include <cstdio>
+
+// bucket i = calls that took [2^i, 2^(i+1)) ticks, the last one catches everything slower.
+// a tick is ~16ns, so 16 buckets reach about 1ms
+#define HOOK_STATS_BUCKETS 16
+#define HOOK_STATS_CORES 3
+// hooks running their own code at the same time, across all threads
+#define HOOK_STATS_ACTIVE 16
+
+struct hook_counters {
+    uint32_t calls;
+    uint64_t ticks;
+    uint32_t buckets[HOOK_STATS_BUCKETS];
+};
+
+// only ever written by the core it belongs to, with interrupts off, so the hooks never wait on anything. seq is odd
+// while an update is in flight, which is how a reader on another core knows to try again
+struct hook_slot {
+    std::atomic<uint32_t> seq;
+    hook_counters counters;
+};
+
+static hook_slot slots[HOOK_STATS_CORES][HOOK_ID_COUNT];
+// where each slot was at the last dump - the slots themselves only count up
+static hook_counters dumped[HOOK_STATS_CORES][HOOK_ID_COUNT];
+
+// which thread is in which hook, so an allocation can be pinned on the hook that made it
+static std::atomic<OSThread *> active_threads[HOOK_STATS_ACTIVE];
+static hook_id active_ids[HOOK_STATS_ACTIVE];
+static std::atomic<uint32_t> allocations[HOOK_ID_COUNT];
+
+static MEMAllocFromDefaultHeapFn real_alloc;
+static MEMAllocFromDefaultHeapExFn real_alloc_ex;
+
+static const char *hook_names[HOOK_ID_COUNT] = {
+        "gethostbyname",
+        "getaddrinfo",
+        "eShop FSOpenFile",
+        "eShop FSReadFile",
+        "eShop FSCloseFile",
+        "OLV FSOpenFile",
+        "OLV FSReadFile",
+        "OLV FSCloseFile",
+        "Account FSOpenFile",
+        "Account FSReadFile",
+        "Account FSCloseFile",
+        "NEX MatchmakeSession::SetAttribute",
+        "NEX SearchCriteria::SetAttribute",
+        "IDBE DownloadIconFile",
+        "title start",
+};
+
+void hook_stats_record(hook_id id, OSTick ticks) {
+    const int bucket = 31 - __builtin_clz((uint32_t) ticks | 1);
+
+    // nothing else on this core can run until interrupts are back on, and the thread can't move to another one - so
+    // the core is read inside the window, and the slot is ours alone for the update
+    const auto interrupts = OSDisableInterrupts();
+    auto &slot = slots[OSGetCoreId() % HOOK_STATS_CORES][id];
+    const auto seq = slot.seq.load(std::memory_order_relaxed);
+    slot.seq.store(seq + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    auto &c = slot.counters;
+    c.calls++;
+    c.ticks += (uint32_t) ticks;
+    c.buckets[bucket < HOOK_STATS_BUCKETS ? bucket : HOOK_STATS_BUCKETS - 1]++;
+
+    slot.seq.store(seq + 2, std::memory_order_release);
+    OSRestoreInterrupts(interrupts);
+}
+
+// a consistent copy of a slot another core may be updating
+static hook_counters snapshot(const hook_slot &slot) {
+    while (true) {
+        const auto seq = slot.seq.load(std::memory_order_acquire);
+        hook_counters copy = slot.counters;
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (!(seq & 1) && slot.seq.load(std::memory_order_relaxed) == seq) return copy;
+    }
+}
+
+int hook_stats_enter(hook_id id) {
+    OSThread *thread = OSGetCurrentThread();
+    for (int i = 0; i < HOOK_STATS_ACTIVE; i++) {
+        OSThread *expected = nullptr;
+        if (active_threads[i].compare_exchange_strong(expected, thread)) {
+            // only this thread looks at the id while the slot is its own
+            active_ids[i] = id;
+            return i;
+        }
+    }
+    return -1;
+}
+
+void hook_stats_leave(int slot) {
+    if (slot >= 0) active_threads[slot] = nullptr;
+}
+
+void hook_stats_note_alloc() {
+    OSThread *thread = OSGetCurrentThread();
+    for (int i = 0; i < HOOK_STATS_ACTIVE; i++) {
+        if (active_threads[i].load(std::memory_order_relaxed) == thread) {
+            allocations[active_ids[i]]++;
+            return;
+        }
+    }
+}
+
+uint32_t hook_stats_allocations(hook_id id) {
+    return allocations[id];
+}
+
+static void *counting_alloc(uint32_t size) {
+    hook_stats_note_alloc();
+    return real_alloc(size);
+}
+
+static void *counting_alloc_ex(uint32_t size, int32_t alignment) {
+    hook_stats_note_alloc();
+    return real_alloc_ex(size, alignment);
+}
+
+void hook_stats_process_start() {
+    // malloc and new end up here. a new process (or a game with its own allocator) may have reset these
+    if (MEMAllocFromDefaultHeap != counting_alloc) {
+        real_alloc = MEMAllocFromDefaultHeap;
+        MEMAllocFromDefaultHeap = counting_alloc;
+    }
+    if (MEMAllocFromDefaultHeapEx != counting_alloc_ex) {
+        real_alloc_ex = MEMAllocFromDefaultHeapEx;
+        MEMAllocFromDefaultHeapEx = counting_alloc_ex;
+    }
+}
+
+uint32_t hook_stats_calls(hook_id id) {
+    uint32_t calls = 0;
+    for (int core = 0; core < HOOK_STATS_CORES; core++) {
+        calls += snapshot(slots[core][id]).calls - dumped[core][id].calls;
+    }
+    return calls;
+}
+
+void hook_stats_dump() {
+    for (int id = 0; id < HOOK_ID_COUNT; id++) {
+        hook_counters total = {};
+        for (int core = 0; core < HOOK_STATS_CORES; core++) {
+            const auto now = snapshot(slots[core][id]);
+            const auto &last = dumped[core][id];
+            total.calls += now.calls - last.calls;
+            total.ticks += now.ticks - last.ticks;
+            for (int b = 0; b < HOOK_STATS_BUCKETS; b++) {
+                total.buckets[b] += now.buckets[b] - last.buckets[b];
+            }
+            dumped[core][id] = now;
+        }
+        if (!total.calls) continue;
+
+        char histogram[HOOK_STATS_BUCKETS * 12] = "";
+        int len = 0;
+        for (int b = 0; b < HOOK_STATS_BUCKETS && len < (int) sizeof(histogram); b++) {
+            if (!total.buckets[b]) continue;
+            len += snprintf(histogram + len, sizeof(histogram) - len, " 2^%d:%u", b, (unsigned) total.buckets[b]);
+        }
+
+        DEBUG_FUNCTION_LINE("Inkay: %s: %u calls, avg %uus, ticks%s", hook_names[id], (unsigned) total.calls,
+                            (unsigned) OSTicksToMicroseconds(total.ticks / total.calls), histogram);
+        if (const auto allocs = allocations[id].load()) {
+            DEBUG_FUNCTION_LINE("Inkay: %s made %u heap allocations since boot!", hook_names[id], (unsigned) allocs);
+        }
+    }
+}
+
+#else
+
+void hook_stats_dump() {
+    DEBUG_FUNCTION_LINE("Inkay: built without HOOK_STATS=1, nothing to dump");
+}
+
+#endif
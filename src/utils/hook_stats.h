@@ -0,0 +1,111 @@
+/*  Copyright 2026 Pretendo Network contributors <pretendo.network>
+
+    Permission to use, copy, modify, and/or distribute this software for any purpose with or without fee is hereby
+    granted, provided that the above copyright notice and this permission notice appear in all copies.
+
+    THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES WITH REGARD TO THIS SOFTWARE INCLUDING ALL
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT,
+    INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER
+    IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR
+    PERFORMANCE OF THIS SOFTWARE.
+*/
+
+
+#pragma once
+
+#include <coreinit/time.h>
+
+#include <cstdint>
+
+/**
+ * Optional per-hook call counters and latency histograms, built in with HOOK_STATS=1. Only Inkay's own time is
+ * measured - HOOK_REAL() pauses the clock while the original function runs. Heap allocations the hooks' own code
+ * makes are counted too, and called out in hook_stats_dump().
+ *
+ *   DECL_FUNCTION(int, foo, int x) {
+ *       HOOK_STATS_SCOPE(HOOK_FOO);
+ *       return HOOK_REAL(real_foo, x + 1);
+ *   }
+ */
+enum hook_id : uint8_t {
+    HOOK_GETHOSTBYNAME,
+    HOOK_GETADDRINFO,
+    HOOK_ESHOP_FSOPENFILE,
+    HOOK_ESHOP_FSREADFILE,
+    HOOK_ESHOP_FSCLOSEFILE,
+    HOOK_OLV_FSOPENFILE,
+    HOOK_OLV_FSREADFILE,
+    HOOK_OLV_FSCLOSEFILE,
+    HOOK_ACCOUNT_FSOPENFILE,
+    HOOK_ACCOUNT_FSREADFILE,
+    HOOK_ACCOUNT_FSCLOSEFILE,
+    HOOK_NEX_SESSION_SETATTRIBUTE,
+    HOOK_NEX_SEARCH_SETATTRIBUTE,
+    HOOK_IDBE_DOWNLOADICONFILE,
+    // not a hook - the work Inkay does as each title starts, which has to stay off the heap just the same
+    HOOK_TITLE_START,
+
+    HOOK_ID_COUNT
+};
+
+// logs every hook that ran since the last reset, then resets
+void hook_stats_dump();
+
+#ifdef HOOK_STATS
+
+void hook_stats_record(hook_id id, OSTick ticks);
+// calls to the hook since the last dump
+uint32_t hook_stats_calls(hook_id id);
+
+// marks the calling thread as running the hook's own code, so heap allocations it makes count against the hook.
+// returns the slot to pass to hook_stats_leave, or -1 if too many hooks are running at once to track this one
+int hook_stats_enter(hook_id id);
+void hook_stats_leave(int slot);
+
+// counts a heap allocation against the hook running on this thread, if there is one
+void hook_stats_note_alloc();
+// heap allocations the hook's own code made since the module started - the hook paths are meant to make none
+uint32_t hook_stats_allocations(hook_id id);
+
+// points the default heap at the counting wrappers, unless it already is - call at every application start
+void hook_stats_process_start();
+
+class hook_scope {
+public:
+    explicit hook_scope(hook_id id) : id(id), slot(hook_stats_enter(id)), start(OSGetSystemTick()) {}
+    ~hook_scope() {
+        hook_stats_leave(slot);
+        hook_stats_record(id, spent + (OSGetSystemTick() - start));
+    }
+
+    template <typename F, typename... Args>
+    auto call(F fn, Args... args) {
+        spent += OSGetSystemTick() - start;
+        // whatever the original function allocates is its own business
+        hook_stats_leave(slot);
+        struct resume {
+            hook_scope &scope;
+            ~resume() {
+                scope.slot = hook_stats_enter(scope.id);
+                scope.start = OSGetSystemTick();
+            }
+        } r{*this};
+        return fn(args...);
+    }
+
+private:
+    hook_id id;
+    int slot;
+    OSTick start;
+    OSTick spent = 0;
+};
+
+#define HOOK_STATS_SCOPE(id) hook_scope hook_stats_scope_(id)
+#define HOOK_REAL(fn, ...) hook_stats_scope_.call(fn, ##__VA_ARGS__)
+
+#else
+
+#define HOOK_STATS_SCOPE(id) do {} while (0)
+#define HOOK_REAL(fn, ...) fn(__VA_ARGS__)
+
+#endif
@@ -0,0 +1,111 @@
+/*  Copyright 2026 Pretendo Network contributors <pretendo.network>
+
+    Permission to use, copy, modify, and/or distribute this software for any purpose with or without fee is hereby
+    granted, provided that the above copyright notice and this permission notice appear in all copies.
+
+    THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES WITH REGARD TO THIS SOFTWARE INCLUDING ALL
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT,
+    INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER
+    IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR
+    PERFORMANCE OF THIS SOFTWARE.
+*/
+
+
+#include "iosu_journal.h"
+#include "logger.h"
+#include "ipc_stats.h"
+
+#include <mocha/mocha.h>
+
+#include <cstring>
+
+// the URL table is a couple dozen strings of ~60 bytes, plus a few single-word patches
+#define IOSU_JOURNAL_ENTRIES 640
+
+struct iosu_journal_entry {
+    uint32_t addr;
+    uint32_t original;
+    uint32_t patched;
+};
+
+static iosu_journal_entry journal[IOSU_JOURNAL_ENTRIES];
+static uint32_t journal_count = 0;
+// set once a whole patch set went in - until then the entries are only good for putting the originals back
+static bool journal_sealed = false;
+
+bool iosu_journal_write32(uint32_t addr, uint32_t value) {
+    if (journal_count == IOSU_JOURNAL_ENTRIES) {
+        DEBUG_FUNCTION_LINE("Inkay: IOSU journal full, can't patch %08x", addr);
+        return false;
+    }
+
+    uint32_t original;
+    if (IPC_CALL(IPC_IOSU_KERNEL, Mocha_IOSUKernelRead32(addr, &original)) != MOCHA_RESULT_SUCCESS) {
+        DEBUG_FUNCTION_LINE("Inkay: failed to read IOSU %08x", addr);
+        return false;
+    }
+
+    journal[journal_count++] = {addr, original, value};
+    return IPC_CALL(IPC_IOSU_KERNEL, Mocha_IOSUKernelWrite32(addr, value)) == MOCHA_RESULT_SUCCESS;
+}
+
+//thanks @Gary#4139 :p
+bool iosu_journal_write_string(uint32_t addr, const char *str) {
+    int len = strlen(str) + 1;
+    int remaining = len % 4;
+    int num = len - remaining;
+
+    bool ok = true;
+    for (int i = 0; i < (num / 4); i++) {
+        uint32_t word;
+        memcpy(&word, str + i * 4, sizeof(word));
+        ok &= iosu_journal_write32(addr + i * 4, word);
+    }
+
+    if (remaining > 0) {
+        uint8_t buf[4];
+        if (IPC_CALL(IPC_IOSU_KERNEL, Mocha_IOSUKernelRead32(addr + num, (uint32_t *) &buf)) != MOCHA_RESULT_SUCCESS)
+            return false;
+
+        for (int i = 0; i < remaining; i++) {
+            buf[i] = *(str + num + i);
+        }
+
+        uint32_t word;
+        memcpy(&word, buf, sizeof(word));
+        ok &= iosu_journal_write32(addr + num, word);
+    }
+
+    return ok;
+}
+
+bool iosu_journal_revert() {
+    bool ok = true;
+    for (uint32_t i = journal_count; i > 0; i--) {
+        const auto &entry = journal[i - 1];
+        ok &= IPC_CALL(IPC_IOSU_KERNEL, Mocha_IOSUKernelWrite32(entry.addr, entry.original)) == MOCHA_RESULT_SUCCESS;
+    }
+    // a partial set is no use for reapplying, so the next attempt records from scratch. if the revert failed too the
+    // originals are still needed
+    if (ok && !journal_sealed) {
+        journal_count = 0;
+    }
+    return ok;
+}
+
+bool iosu_journal_reapply() {
+    bool ok = true;
+    for (uint32_t i = 0; i < journal_count; i++) {
+        const auto &entry = journal[i];
+        ok &= IPC_CALL(IPC_IOSU_KERNEL, Mocha_IOSUKernelWrite32(entry.addr, entry.patched)) == MOCHA_RESULT_SUCCESS;
+    }
+    return ok;
+}
+
+void iosu_journal_seal() {
+    journal_sealed = true;
+}
+
+bool iosu_journal_recorded() {
+    return journal_sealed;
+}
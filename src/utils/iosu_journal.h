@@ -0,0 +1,36 @@
+/*  Copyright 2026 Pretendo Network contributors <pretendo.network>
+
+    Permission to use, copy, modify, and/or distribute this software for any purpose with or without fee is hereby
+    granted, provided that the above copyright notice and this permission notice appear in all copies.
+
+    THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES WITH REGARD TO THIS SOFTWARE INCLUDING ALL
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT,
+    INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER
+    IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR
+    PERFORMANCE OF THIS SOFTWARE.
+*/
+
+
+#pragma once
+
+#include <cstdint>
+
+/**
+ * Every IOSU write Inkay makes goes through here, so the original words are on hand to switch networks without a
+ * reboot. Writes are recorded once and sealed when the whole set went in; after that the journal can flip the set
+ * back and forth.
+ */
+// writes value to addr, remembering what was there first - false if the journal is full or the read failed
+bool iosu_journal_write32(uint32_t addr, uint32_t value);
+// writes a NUL-terminated string, read-modify-writing the last word
+bool iosu_journal_write_string(uint32_t addr, const char *str);
+
+// puts back the original words, newest first. An unsealed journal is emptied if that worked
+bool iosu_journal_revert();
+// writes the patched words again after a revert
+bool iosu_journal_reapply();
+
+// marks what's recorded as the complete patch set
+void iosu_journal_seal();
+// true if a complete patch set is recorded
+bool iosu_journal_recorded();
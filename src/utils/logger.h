@@ -10,8 +10,13 @@
 extern "C" {
 #endif
 
+// GCC 12+ hands us the basename at compile time, older compilers have to look for it on every log call
+#ifdef __FILE_NAME__
+#define __FILENAME__ __FILE_NAME__
+#else
 #define __FILENAME_X__ (strrchr(__FILE__, '\\') ? strrchr(__FILE__, '\\') + 1 : __FILE__)
 #define __FILENAME__ (strrchr(__FILE__, '/') ? strrchr(__FILE__, '/') + 1 : __FILENAME_X__)
+#endif
 
 #define OSFATAL_FUNCTION_LINE(FMT, ARGS...)do { \
     OSFatal_printf("[(M)             Inkay][%23s]%30s@L%04d: " FMT "",__FILENAME__,__FUNCTION__, __LINE__, ## ARGS); \
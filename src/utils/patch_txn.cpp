@@ -0,0 +1,176 @@
+/*  Copyright 2026 Pretendo Network contributors <pretendo.network>
+
+    Permission to use, copy, modify, and/or distribute this software for any purpose with or without fee is hereby
+    granted, provided that the above copyright notice and this permission notice appear in all copies.
+
+    THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES WITH REGARD TO THIS SOFTWARE INCLUDING ALL
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT,
+    INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER
+    IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR
+    PERFORMANCE OF THIS SOFTWARE.
+*/
+
+
+#include "patch_txn.h"
+#include "logger.h"
+
+#include <coreinit/cache.h>
+#include <coreinit/memorymap.h>
+#include <kernel/kernel.h>
+
+#include <cstring>
+
+#define PATCH_JOURNAL_ENTRIES 64
+#define PATCH_JOURNAL_BYTES 4096
+
+struct journal_entry {
+    uint32_t addr;
+    uint16_t len;
+    uint16_t offset;
+    bool code;
+};
+
+static journal_entry journal[PATCH_JOURNAL_ENTRIES];
+static uint8_t journal_bytes[PATCH_JOURNAL_BYTES];
+static uint32_t journal_count = 0;
+static uint32_t journal_used = 0;
+static uint32_t untracked_writes = 0;
+
+// 0 means the address isn't mapped (any more) - KernelCopyData would happily write to physical 0
+static bool can_write(uint32_t addr, const uint8_t *data) {
+    return OSEffectiveToPhysical(addr) && OSEffectiveToPhysical((uint32_t) (uintptr_t) data);
+}
+
+static bool write_memory(uint32_t addr, const uint8_t *data, uint32_t len) {
+    if (!can_write(addr, data)) {
+        DEBUG_FUNCTION_LINE("Inkay: %08x isn't mapped, skipping write", addr);
+        return false;
+    }
+    KernelCopyData(OSEffectiveToPhysical(addr), OSEffectiveToPhysical((uint32_t) (uintptr_t) data), len);
+    return true;
+}
+
+static void flush(uint32_t addr, uint32_t len, bool code) {
+    DCFlushRange((void *) (uintptr_t) addr, len);
+    if (code) ICInvalidateRange((void *) (uintptr_t) addr, len);
+}
+
+bool PatchTransaction::stage(uint32_t addr, std::span<const uint8_t> repl, bool code) {
+    if (failed) return false;
+    if (count == max_writes || used + repl.size() * 2 > max_bytes || repl.empty()) {
+        DEBUG_FUNCTION_LINE("Inkay: patch transaction full, can't stage %08x", addr);
+        failed = true;
+        return false;
+    }
+
+    auto &w = writes[count++];
+    w = {addr, (uint16_t) repl.size(), (uint16_t) used, code};
+    memcpy(&bytes[used], (const void *) (uintptr_t) addr, repl.size());
+    memcpy(&bytes[used + repl.size()], repl.data(), repl.size());
+    used += repl.size() * 2;
+    return true;
+}
+
+bool PatchTransaction::replace(uint32_t start, uint32_t size, const void *original_val, size_t original_val_sz,
+                               const void *new_val, size_t new_val_sz) {
+    ScanQueue queue(this);
+    const auto index = queue.add(original_val, original_val_sz, new_val, new_val_sz);
+    queue.run(start, size);
+
+    if (!queue.matches(index)) {
+        failed = true;
+        return false;
+    }
+    return ok();
+}
+
+template <typename U>
+    requires std::integral<U>
+bool PatchTransaction::replace_unsigned(U *addr, U original_value, U new_value) {
+    if (*addr != original_value) {
+        DEBUG_FUNCTION_LINE("Inkay: %08x isn't what we expected", (uint32_t) (uintptr_t) addr);
+        failed = true;
+        return false;
+    }
+    return stage((uint32_t) (uintptr_t) addr, std::span((const uint8_t *) &new_value, sizeof(new_value)));
+}
+template bool PatchTransaction::replace_unsigned<uint32_t>(uint32_t *, uint32_t, uint32_t);
+template bool PatchTransaction::replace_unsigned<uint16_t>(uint16_t *, uint16_t, uint16_t);
+template bool PatchTransaction::replace_unsigned<uint8_t>(uint8_t *, uint8_t, uint8_t);
+
+bool PatchTransaction::replace_instruction(uint32_t *inst, uint32_t original_value, uint32_t new_value) {
+    if (*inst != original_value) {
+        DEBUG_FUNCTION_LINE("Inkay: instruction at %08x isn't what we expected", (uint32_t) (uintptr_t) inst);
+        failed = true;
+        return false;
+    }
+    return stage((uint32_t) (uintptr_t) inst, std::span((const uint8_t *) &new_value, sizeof(new_value)), true);
+}
+
+bool PatchTransaction::commit() {
+    if (failed) return false;
+
+    if (journal_count + count > PATCH_JOURNAL_ENTRIES || journal_used + used / 2 > PATCH_JOURNAL_BYTES) {
+        DEBUG_FUNCTION_LINE("Inkay: patch journal full, not committing");
+        failed = true;
+        return false;
+    }
+
+    // something else may have gotten there (or unmapped it) between staging and now. either way, nothing gets written
+    for (size_t i = 0; i < count; i++) {
+        const auto &w = writes[i];
+        if (!can_write(w.addr, &bytes[w.offset + w.len])) {
+            DEBUG_FUNCTION_LINE("Inkay: %08x isn't mapped, not committing", w.addr);
+            failed = true;
+            return false;
+        }
+        if (memcmp((const void *) (uintptr_t) w.addr, &bytes[w.offset], w.len) != 0) {
+            DEBUG_FUNCTION_LINE("Inkay: %08x changed since it was staged, not committing", w.addr);
+            failed = true;
+            return false;
+        }
+    }
+
+    for (size_t i = 0; i < count; i++) {
+        const auto &w = writes[i];
+        write_memory(w.addr, &bytes[w.offset + w.len], w.len);
+
+        journal[journal_count++] = {w.addr, w.len, (uint16_t) journal_used, w.code};
+        memcpy(&journal_bytes[journal_used], &bytes[w.offset], w.len);
+        journal_used += w.len;
+    }
+    for (size_t i = 0; i < count; i++) {
+        flush(writes[i].addr, writes[i].len, writes[i].code);
+    }
+
+    DEBUG_FUNCTION_LINE_VERBOSE("Inkay: committed %u patches", (unsigned) count);
+    return true;
+}
+
+void patch_journal_rollback() {
+    for (uint32_t i = journal_count; i > 0; i--) {
+        const auto &entry = journal[i - 1];
+        write_memory(entry.addr, &journal_bytes[entry.offset], entry.len);
+    }
+    for (uint32_t i = 0; i < journal_count; i++) {
+        flush(journal[i].addr, journal[i].len, journal[i].code);
+    }
+
+    DEBUG_FUNCTION_LINE_VERBOSE("Inkay: rolled back %u patches", (unsigned) journal_count);
+    journal_count = 0;
+    journal_used = 0;
+}
+
+void patch_journal_reset() {
+    journal_count = 0;
+    journal_used = 0;
+    untracked_writes = 0;
+}
+
+void patch_journal_note_untracked(uint32_t writes) {
+    untracked_writes += writes;
+}
+
+uint32_t patch_journal_untracked() {
+    return untracked_writes;
+}
@@ -0,0 +1,78 @@
+/*  Copyright 2026 Pretendo Network contributors <pretendo.network>
+
+    Permission to use, copy, modify, and/or distribute this software for any purpose with or without fee is hereby
+    granted, provided that the above copyright notice and this permission notice appear in all copies.
+
+    THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES WITH REGARD TO THIS SOFTWARE INCLUDING ALL
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT,
+    INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER
+    IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR
+    PERFORMANCE OF THIS SOFTWARE.
+*/
+
+
+#pragma once
+
+#include "replace_mem.h"
+
+#include <array>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+/**
+ * Stages a set of memory patches and writes them all or none of them. Nothing touches memory until commit(), which
+ * rechecks that every target is still mapped and still holds its original, writes everything, then does the cache
+ * maintenance in one pass. Committed originals go to
+ * the per-process journal, so patch_journal_rollback() can undo them later.
+ *
+ * Any staging step that fails (needle not found, value didn't match, out of space) poisons the transaction and
+ * commit() will refuse it - so there's no half-patched state to clean up.
+ */
+class PatchTransaction {
+public:
+    static constexpr size_t max_writes = 16;
+    static constexpr size_t max_bytes = 1024; ///< originals and replacements together
+
+    // stages repl over whatever is at addr right now
+    bool stage(uint32_t addr, std::span<const uint8_t> repl, bool code = false);
+
+    // same as the free functions in replace_mem.h, but staged
+    bool replace(uint32_t start, uint32_t size, const void *original_val, size_t original_val_sz,
+                 const void *new_val, size_t new_val_sz);
+    template <typename U>
+        requires std::integral<U>
+    bool replace_unsigned(U *addr, U original_value, U new_value);
+    bool replace_instruction(uint32_t *inst, uint32_t original_value, uint32_t new_value);
+
+    // for callers scanning with their own ScanQueue(&txn) - a request that should have matched but didn't
+    void fail() { failed = true; }
+
+    bool commit();
+    bool ok() const { return !failed; }
+    size_t size() const { return count; }
+
+private:
+    struct write {
+        uint32_t addr;
+        uint16_t len;
+        uint16_t offset; ///< original at bytes[offset], replacement right after it
+        bool code;
+    };
+
+    std::array<write, max_writes> writes{};
+    std::array<uint8_t, max_bytes> bytes{};
+    size_t count = 0;
+    size_t used = 0;
+    bool failed = false;
+};
+
+// puts back everything committed in this process, newest first
+void patch_journal_rollback();
+// forgets the journal - the memory it describes went away with the old process
+void patch_journal_reset();
+
+// for writes that didn't go through a transaction and so can't be rolled back
+void patch_journal_note_untracked(uint32_t writes);
+uint32_t patch_journal_untracked();
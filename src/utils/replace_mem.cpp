@@ -18,59 +18,268 @@
 
 #include "replace_mem.h"
 #include "utils/logger.h"
+#include "utils/patch_txn.h"
+#include "utils/trace.h"
 
 #include <kernel/kernel.h>
 #include <coreinit/memorymap.h>
 #include <algorithm>
 #include <coreinit/cache.h>
+#include <coreinit/time.h>
 
-bool replace(uint32_t start, uint32_t size, const char *original_val, size_t original_val_sz, const char *new_val,
-             size_t new_val_sz) {
-    for (uint32_t addr = start; addr < start + size - original_val_sz; addr++) {
-        int ret = memcmp(original_val, (void *) addr, original_val_sz);
-        if (ret == 0) {
-            DEBUG_FUNCTION_LINE_VERBOSE("found str @%08x: %s", addr, (const char *) addr);
-            KernelCopyData(OSEffectiveToPhysical(addr), OSEffectiveToPhysical((uint32_t) new_val), new_val_sz);
-            DEBUG_FUNCTION_LINE_VERBOSE("new str   @%08x: %s", addr, (const char *) addr);
-            return true;
+// Cafe OS maps memory in 128KiB chunks, so that's the granularity we check at
+#define SCAN_PAGE_SIZE 0x20000u
+
+static inline uint64_t page_floor(uint64_t addr) {
+    return addr & ~(uint64_t) (SCAN_PAGE_SIZE - 1);
+}
+
+static inline bool is_mapped(uint64_t addr) {
+    return OSEffectiveToPhysical((uint32_t) addr) != 0;
+}
+
+static bool range_is_zero(uint32_t start, uint32_t end) {
+    while (start < end && (start & 3)) {
+        if (*(const uint8_t *) (uintptr_t) start) return false;
+        start++;
+    }
+
+    uint32_t aligned_end = std::max(start, end & ~3u);
+    auto *word = (const uint32_t *) (uintptr_t) start;
+    auto *word_end = (const uint32_t *) (uintptr_t) aligned_end;
+    for (; word + 4 <= word_end; word += 4) {
+        if (word[0] | word[1] | word[2] | word[3]) return false;
+    }
+    for (; word < word_end; word++) {
+        if (*word) return false;
+    }
+
+    for (uint32_t addr = aligned_end; addr < end; addr++) {
+        if (*(const uint8_t *) (uintptr_t) addr) return false;
+    }
+    return true;
+}
+
+static size_t leading_zeros(std::span<const uint8_t> needle) {
+    size_t count = 0;
+    while (count < needle.size() && needle[count] == 0) count++;
+    return count;
+}
+
+/**
+ * Walks [start, start + size) and calls scan(first, last, limit) for every range of candidate start addresses (last
+ * exclusive) that a needle of at least needle_sz bytes could match at. Unmapped pages are skipped entirely and never
+ * read. All-zero pages are skipped too, except for the last lead_zeros bytes, where a needle starting with that many
+ * zero bytes could still begin. Everything below limit is mapped; longer needles must check against it.
+ * scan returns false to stop the walk early.
+ */
+template <typename F>
+static bool scan_populated(uint32_t start, uint32_t size, size_t needle_sz, size_t lead_zeros, F &&scan) {
+    const uint64_t end = (uint64_t) start + size;
+    // a needle that's nothing but zeros would match inside zero pages too
+    const bool skip_zero = lead_zeros < needle_sz;
+
+    uint64_t addr = start;
+    while (addr < end) {
+        uint64_t next = std::min(page_floor(addr) + SCAN_PAGE_SIZE, end);
+        if (!is_mapped(addr)) {
+            addr = next;
+            continue;
+        }
+
+        uint64_t run_end = next;
+        while (run_end < end && is_mapped(run_end)) {
+            run_end = std::min(run_end + SCAN_PAGE_SIZE, end);
+        }
+        if (run_end - addr < needle_sz) {
+            addr = run_end;
+            continue;
+        }
+
+        // matches can't start past here without reading off the end of the mapping
+        const uint64_t last_start = run_end - needle_sz + 1;
+        auto emit = [&](uint64_t first, uint64_t last) {
+            last = std::min(last, last_start);
+            if (first >= last) return true;
+            return scan((uint32_t) first, (uint32_t) last, run_end);
+        };
+
+        uint64_t populated_start = addr;
+        for (uint64_t chunk = addr; chunk < run_end;) {
+            uint64_t chunk_end = std::min(page_floor(chunk) + SCAN_PAGE_SIZE, run_end);
+            if (skip_zero && range_is_zero((uint32_t) chunk, (uint32_t) chunk_end)) {
+                if (!emit(populated_start, chunk)) return false;
+                populated_start = std::max(chunk, chunk_end - std::min<uint64_t>(lead_zeros, chunk_end - chunk));
+            }
+            chunk = chunk_end;
         }
+        if (!emit(populated_start, run_end)) return false;
+
+        addr = run_end;
+    }
+
+    return true;
+}
+
+size_t ScanQueue::add(std::span<const uint8_t> orig, std::span<const uint8_t> repl, match_policy policy) {
+    if (count == capacity || orig.empty()) {
+        DEBUG_FUNCTION_LINE("Can't queue scan request %u!", (unsigned) count);
+        return capacity;
     }
 
-    return false;
+    requests[count] = {
+            .orig = orig,
+            .repl = repl,
+            .policy = policy,
+            .matches = 0,
+            .first_addr = 0,
+    };
+    return count++;
 }
 
-void replaceBulk(uint32_t start, uint32_t size, std::span<const replacement> replacements) {
-    // work out the biggest input replacement
-    auto max_sz = std::max_element(replacements.begin(), replacements.end(), [](auto &a, auto &b) {
-        return a.orig.size_bytes() < b.orig.size_bytes();
-    })->orig.size_bytes();
+size_t ScanQueue::add(const void *orig, size_t orig_sz, const void *repl, size_t repl_sz, match_policy policy) {
+    return add(std::span((const uint8_t *) orig, orig_sz), std::span((const uint8_t *) repl, repl_sz), policy);
+}
 
-    int counts[replacements.size()];
-    for (auto &c: counts) {
-        c = 0;
+bool ScanQueue::done() const {
+    for (size_t i = 0; i < count; i++) {
+        if (pending(requests[i])) return false;
     }
+    return true;
+}
+
+void ScanQueue::run(uint32_t start, uint32_t size) {
+    // bit i set = request i starts with that byte
+    uint8_t first_bytes[256] = {};
+    size_t min_sz = SIZE_MAX;
+    size_t lead_zeros = 0;
+    size_t remaining_first = 0;
+    bool has_all = false;
+
+    for (size_t i = 0; i < count; i++) {
+        const auto &request = requests[i];
+        if (!pending(request)) continue;
+
+        first_bytes[request.orig[0]] |= 1 << i;
+        min_sz = std::min(min_sz, request.orig.size());
+        auto zeros = leading_zeros(request.orig);
+        // all-zero needle, can't skip anything
+        lead_zeros = std::max(lead_zeros, zeros == request.orig.size() ? SIZE_MAX : zeros);
+
+        if (request.policy == match_policy::All) has_all = true;
+        else remaining_first++;
+    }
+    if (!remaining_first && !has_all) return;
+    if (size < min_sz || cancelled()) return;
+
+    const auto started = OSGetSystemTick();
+    scan_stats_.requested += size;
+    scan_stats_.runs++;
 
-    for (uint32_t addr = start; addr < start + size - max_sz; addr++) {
-        for (int i = 0; i < (int) replacements.size(); i++) {
-            const auto &replacement = replacements[i];
-
-            int ret = memcmp((void *) addr, replacement.orig.data(), replacement.orig.size_bytes());
-            if (ret == 0) {
-                KernelCopyData(
-                        OSEffectiveToPhysical(addr),
-                        OSEffectiveToPhysical((uint32_t) replacement.repl.data()),
-                        replacement.repl.size_bytes()
-                );
-                counts[i]++;
-                break; // don't check the other replacements
+    scan_populated(start, size, min_sz, lead_zeros, [&](uint32_t first, uint32_t last, uint64_t limit) {
+        scan_stats_.scanned += last - first;
+        // a page at a time, so a cancel doesn't have to wait for the whole range
+        for (uint32_t page = first; page < last;) {
+            if (cancelled()) return false;
+            const auto page_end = (uint32_t) std::min<uint64_t>(page_floor(page) + SCAN_PAGE_SIZE, last);
+            for (uint32_t addr = page; addr < page_end; addr++) {
+                uint8_t candidates = first_bytes[*(const uint8_t *) (uintptr_t) addr];
+                while (candidates) {
+                    const int i = __builtin_ctz(candidates);
+                    candidates &= candidates - 1;
+
+                    auto &request = requests[i];
+                    if (addr + request.orig.size() > limit) continue;
+                    if (memcmp((void *) (uintptr_t) addr, request.orig.data(), request.orig.size()) != 0) continue;
+
+                    trace(TRACE_SCAN_MATCH, i, addr);
+                    if (txn) {
+                        txn->stage(addr, request.repl);
+                    } else {
+                        KernelCopyData(
+                                OSEffectiveToPhysical(addr),
+                                OSEffectiveToPhysical((uint32_t) (uintptr_t) request.repl.data()),
+                                request.repl.size_bytes()
+                        );
+                        patch_journal_note_untracked(1);
+                    }
+                    if (request.matches++ == 0) request.first_addr = addr;
+
+                    if (request.policy == match_policy::First) {
+                        for (auto &bits: first_bytes) {
+                            bits &= ~(1 << i);
+                        }
+                        // nothing left to look for
+                        if (--remaining_first == 0 && !has_all) return false;
+                    }
+                    break; // don't check the other requests
+                }
             }
+            page = page_end;
         }
+        return true;
+    });
+
+    scan_stats_.ticks += OSGetSystemTick() - started;
+}
+
+void log_scan_stats(const char *what, const scan_stats &stats) {
+    const auto us = std::max<uint32_t>(OSTicksToMicroseconds(stats.ticks), 1);
+    DEBUG_FUNCTION_LINE("Inkay: %s: %u runs, scanned %u of %u KiB in %u us (%u MB/s)", what, (unsigned) stats.runs,
+                        (unsigned) (stats.scanned >> 10), (unsigned) (stats.requested >> 10), (unsigned) us,
+                        (unsigned) (stats.requested / us));
+}
+
+void ScanQueue::run(std::span<const mem_region> regions) {
+    for (const auto &region: regions) {
+        if (done() || cancelled()) return;
+        run(region.start, region.size);
     }
-#ifdef DEBUG
-    for (auto c: counts) {
-        DEBUG_FUNCTION_LINE("replaced %d times", c);
+}
+
+bool replace(uint32_t start, uint32_t size, const char *original_val, size_t original_val_sz, const char *new_val,
+             size_t new_val_sz) {
+    ScanQueue queue;
+    auto index = queue.add(original_val, original_val_sz, new_val, new_val_sz);
+    queue.run(start, size);
+    return queue.matches(index) > 0;
+}
+
+bool replace(std::span<const mem_region> regions, const char *original_val, size_t original_val_sz,
+             const char *new_val, size_t new_val_sz) {
+    ScanQueue queue;
+    auto index = queue.add(original_val, original_val_sz, new_val, new_val_sz);
+    queue.run(regions);
+    return queue.matches(index) > 0;
+}
+
+size_t replaceBulk(std::span<const mem_region> regions, std::span<const replacement> replacements,
+                   const std::atomic<bool> *cancel) {
+    size_t total = 0;
+
+    // usually all of them fit in one queue, so one pass over memory
+    for (size_t first = 0; first < replacements.size(); first += ScanQueue::capacity) {
+        ScanQueue queue(nullptr, cancel);
+        auto batch = replacements.subspan(first, std::min(ScanQueue::capacity, replacements.size() - first));
+        for (const auto &replacement: batch) {
+            queue.add(replacement.orig, replacement.repl, match_policy::All);
+        }
+
+        queue.run(regions);
+
+        for (size_t i = 0; i < queue.size(); i++) {
+            DEBUG_FUNCTION_LINE_VERBOSE("replaced %d times", queue.matches(i));
+            total += queue.matches(i);
+        }
     }
-#endif
+
+    return total;
+}
+
+size_t replaceBulk(uint32_t start, uint32_t size, std::span<const replacement> replacements,
+                   const std::atomic<bool> *cancel) {
+    const mem_region region = {start, size};
+    return replaceBulk(std::span(&region, 1), replacements, cancel);
 }
 
 template <typename U>
@@ -79,11 +288,12 @@ bool replace_unsigned(U *addr, U original_value, U new_value) {
     if (*addr != original_value) return false;
 
     KernelCopyData(
-            OSEffectiveToPhysical((uint32_t) addr),
-            OSEffectiveToPhysical((uint32_t) &new_value),
+            OSEffectiveToPhysical((uint32_t) (uintptr_t) addr),
+            OSEffectiveToPhysical((uint32_t) (uintptr_t) &new_value),
             sizeof(new_value)
     );
     DCFlushRange(addr, sizeof(new_value));
+    patch_journal_note_untracked(1);
 
     DEBUG_FUNCTION_LINE_VERBOSE("%08x is now %08x", inst, *inst);
     return *addr == new_value;
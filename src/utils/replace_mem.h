@@ -14,19 +14,103 @@
 
 #pragma once
 
+#include <array>
+#include <atomic>
 #include <cstdint>
 #include <cstddef>
 #include <span>
 
+struct mem_region {
+    uint32_t start;
+    uint32_t size;
+};
+
+class PatchTransaction;
+
+// what a ScanQueue has done so far, for judging changes to the scan engine on real memory
+struct scan_stats {
+    uint64_t requested; ///< bytes run() was asked to cover
+    uint64_t scanned;   ///< bytes actually compared - the rest was unmapped or zero pages
+    uint32_t ticks;     ///< OSGetSystemTick time spent in run()
+    uint32_t runs;
+};
+
+enum class match_policy {
+    First, ///< Stop looking for the needle after the first match
+    All,   ///< Replace every occurrence
+};
+
+/**
+ * Collects needles and replaces all of them in one pass over memory, rather than one pass per needle.
+ *
+ * A request that already matched with match_policy::First is skipped by later runs, so a queue can be run over a few
+ * likely regions first and then over a fallback window for whatever is still missing.
+ *
+ * Given a PatchTransaction, matches are staged in it instead of written straight away. Given a cancel flag, run() checks
+ * it once per page and gives up as soon as it's set.
+ */
+class ScanQueue {
+public:
+    static constexpr size_t capacity = 8;
+
+    explicit ScanQueue(PatchTransaction *txn = nullptr, const std::atomic<bool> *cancel = nullptr)
+        : txn(txn), cancel(cancel) {}
+
+    // returns the request's index for matches(), or capacity if the queue is full
+    size_t add(std::span<const uint8_t> orig, std::span<const uint8_t> repl,
+               match_policy policy = match_policy::First);
+    size_t add(const void *orig, size_t orig_sz, const void *repl, size_t repl_sz,
+               match_policy policy = match_policy::First);
+
+    void run(uint32_t start, uint32_t size);
+    void run(std::span<const mem_region> regions);
+
+    // true once every request has matched - never true while a match_policy::All request is queued
+    bool done() const;
+    bool cancelled() const { return cancel && cancel->load(std::memory_order_relaxed); }
+    uint32_t matches(size_t index) const { return index < count ? requests[index].matches : 0; }
+    // address of the request's first match, 0 if it hasn't matched
+    uint32_t first_match(size_t index) const { return index < count ? requests[index].first_addr : 0; }
+    size_t size() const { return count; }
+    const scan_stats &stats() const { return scan_stats_; }
+
+private:
+    struct request {
+        std::span<const uint8_t> orig;
+        std::span<const uint8_t> repl;
+        match_policy policy;
+        uint32_t matches;
+        uint32_t first_addr;
+    };
+
+    static bool pending(const request &r) { return r.policy == match_policy::All || r.matches == 0; }
+
+    std::array<request, capacity> requests{};
+    size_t count = 0;
+    PatchTransaction *txn;
+    const std::atomic<bool> *cancel;
+    scan_stats scan_stats_{};
+};
+
+// one log line with throughput - in MB/s of memory asked for, so skipped pages count in our favour
+void log_scan_stats(const char *what, const scan_stats &stats);
+
 bool replace(uint32_t start, uint32_t size, const char *original_val, size_t original_val_sz, const char *new_val,
              size_t new_val_sz);
+// same as above, but only searches the given regions (e.g. from collect_heap_regions)
+bool replace(std::span<const mem_region> regions, const char *original_val, size_t original_val_sz,
+             const char *new_val, size_t new_val_sz);
 
 struct replacement {
     std::span<const uint8_t> orig;
     std::span<const uint8_t> repl;
 };
 
-void replaceBulk(uint32_t start, uint32_t size, std::span<const replacement> replacements);
+// returns the total number of replacements made - if cancel gets set partway, just the ones made until then
+size_t replaceBulk(uint32_t start, uint32_t size, std::span<const replacement> replacements,
+                   const std::atomic<bool> *cancel = nullptr);
+size_t replaceBulk(std::span<const mem_region> regions, std::span<const replacement> replacements,
+                   const std::atomic<bool> *cancel = nullptr);
 
 template <typename U>
     requires std::integral<U>
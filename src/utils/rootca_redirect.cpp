@@ -0,0 +1,62 @@
+/*  Copyright 2026 Pretendo Network contributors <pretendo.network>
+
+    Permission to use, copy, modify, and/or distribute this software for any purpose with or without fee is hereby
+    granted, provided that the above copyright notice and this permission notice appear in all copies.
+
+    THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES WITH REGARD TO THIS SOFTWARE INCLUDING ALL
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT,
+    INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER
+    IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR
+    PERFORMANCE OF THIS SOFTWARE.
+*/
+
+
+#include "rootca_redirect.h"
+#include "logger.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "ca_pem.h" // generated at buildtime
+
+// indexed by trace_hook
+static const char *const hook_names[] = {
+        "eShop",
+        "Miiverse",
+        "account settings",
+};
+
+bool RootCaRedirect::is_rootca(const char *path) {
+    return strcmp("vol/content/browser/rootca.pem", path) == 0;
+}
+
+void RootCaRedirect::opened(int status, FSFileHandle opened_handle) {
+    if (status < 0) return;
+
+    offset = 0;
+    handle = opened_handle;
+    DEBUG_FUNCTION_LINE_VERBOSE("Inkay: Found %s CA, replacing...", hook_names[hook]);
+}
+
+bool RootCaRedirect::read(FSFileHandle read_handle, uint8_t *buffer, uint32_t size, uint32_t count) {
+    if (handle.load(std::memory_order_relaxed) != read_handle) return false;
+
+    if (size != 1) {
+        DEBUG_FUNCTION_LINE("Inkay: %s CA replacement failed!", hook_names[hook]);
+    }
+    const uint32_t len = size * count;
+    trace(TRACE_CA_REPLACED, hook, len);
+
+    // the applet sized its reads for the file on disk, which is bigger than ours - serve the bundle from wherever
+    // the last read left off and pad with NULs so the parser sees it end
+    const uint32_t start = std::min(offset.fetch_add(len), (uint32_t) ca_pem_size);
+    const uint32_t copied = std::min(len, (uint32_t) ca_pem_size - start);
+    memcpy(buffer, ca_pem + start, copied);
+    memset(buffer + copied, 0, len - copied);
+    return true;
+}
+
+void RootCaRedirect::closed(FSFileHandle closed_handle) {
+    auto expected = closed_handle;
+    handle.compare_exchange_strong(expected, NO_HANDLE);
+}
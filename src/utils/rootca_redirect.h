@@ -0,0 +1,45 @@
+/*  Copyright 2026 Pretendo Network contributors <pretendo.network>
+
+    Permission to use, copy, modify, and/or distribute this software for any purpose with or without fee is hereby
+    granted, provided that the above copyright notice and this permission notice appear in all copies.
+
+    THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES WITH REGARD TO THIS SOFTWARE INCLUDING ALL
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT,
+    INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER
+    IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR
+    PERFORMANCE OF THIS SOFTWARE.
+*/
+
+
+#pragma once
+
+#include "trace.h"
+
+#include <atomic>
+#include <cstdint>
+#include <coreinit/filesystem.h>
+
+/**
+ * Serves our CA bundle in place of an applet's vol/content/browser/rootca.pem. The FS hooks run on whatever thread the
+ * applet does its file I/O on, so the handle and read position are atomics rather than an optional.
+ */
+class RootCaRedirect {
+public:
+    explicit constexpr RootCaRedirect(trace_hook hook) : hook(hook) {}
+
+    static bool is_rootca(const char *path);
+
+    // call with the result of the real FSOpenFile - a failed open doesn't take over anything
+    void opened(int status, FSFileHandle handle);
+    // true if handle is the CA file, in which case buffer has been filled from our bundle
+    bool read(FSFileHandle handle, uint8_t *buffer, uint32_t size, uint32_t count);
+    void closed(FSFileHandle handle);
+
+private:
+    // FS handles are small indices, so this is never a real one
+    static constexpr FSFileHandle NO_HANDLE = ~0u;
+
+    trace_hook hook;
+    std::atomic<FSFileHandle> handle = NO_HANDLE;
+    std::atomic<uint32_t> offset = 0;
+};
@@ -13,52 +13,193 @@
 
 #include "rpl_info.h"
 
-#include <vector>
 #include <algorithm>
 #include <string_view>
-#include <coreinit/mcp.h>
-#include <coreinit/title.h>
 
 #include "logger.h"
 
-// if we get more than like.. two callsites for this, it should really be refactored out rather than doing a fresh
-// search every time
-std::optional<OSDynLoad_NotifyData> search_for_rpl(std::string_view name) {
+// open addressing, so keep this a power of two and comfortably bigger than the number of RPLs a title loads
+#define RPL_INDEX_SLOTS 128
+#define RPL_MAX_SUBSCRIBERS 8
+
+#define RPL_SLOT_EMPTY 0
+#define RPL_SLOT_DELETED 1
+
+struct rpl_slot {
+    uint32_t hash;
+    OSDynLoad_NotifyData rpl;
+};
+
+struct rpl_subscriber {
+    uint32_t hash;
+    std::string_view name;
+    rpl_notify_fn callback;
+};
+
+static rpl_slot rpl_index[RPL_INDEX_SLOTS];
+static size_t rpl_count = 0;
+static bool rpl_index_active = false;
+
+static rpl_subscriber rpl_subscribers[RPL_MAX_SUBSCRIBERS];
+static size_t rpl_subscriber_count = 0;
+
+// loader paths can have a directory on the front, we only care about the file name
+static std::string_view rpl_basename(std::string_view path) {
+    auto slash = path.find_last_of("/\\");
+    return slash == std::string_view::npos ? path : path.substr(slash + 1);
+}
+
+// FNV-1a, kept clear of the empty/deleted markers
+static uint32_t rpl_hash(std::string_view name) {
+    uint32_t hash = 2166136261u;
+    for (char c: name) {
+        hash = (hash ^ (uint8_t) c) * 16777619u;
+    }
+    return hash > RPL_SLOT_DELETED ? hash : hash + 2;
+}
+
+static rpl_slot *rpl_find_slot(uint32_t hash, std::string_view name) {
+    for (uint32_t i = 0; i < RPL_INDEX_SLOTS; i++) {
+        auto &slot = rpl_index[(hash + i) & (RPL_INDEX_SLOTS - 1)];
+        if (slot.hash == RPL_SLOT_EMPTY) return nullptr;
+        if (slot.hash == hash && rpl_basename(slot.rpl.name) == name) return &slot;
+    }
+    return nullptr;
+}
+
+static void rpl_index_add(const OSDynLoad_NotifyData &rpl) {
+    if (!rpl.name) return;
+    auto name = rpl_basename(rpl.name);
+    auto hash = rpl_hash(name);
+
+    if (auto *existing = rpl_find_slot(hash, name)) {
+        existing->rpl = rpl;
+        return;
+    }
+
+    for (uint32_t i = 0; i < RPL_INDEX_SLOTS; i++) {
+        auto &slot = rpl_index[(hash + i) & (RPL_INDEX_SLOTS - 1)];
+        if (slot.hash == RPL_SLOT_EMPTY || slot.hash == RPL_SLOT_DELETED) {
+            slot = {hash, rpl};
+            rpl_count++;
+            return;
+        }
+    }
+    DEBUG_FUNCTION_LINE("RPL index full, can't track %s!", rpl.name);
+}
+
+static void rpl_index_remove(const OSDynLoad_NotifyData &rpl) {
+    if (!rpl.name) return;
+    auto name = rpl_basename(rpl.name);
+
+    if (auto *slot = rpl_find_slot(rpl_hash(name), name)) {
+        slot->hash = RPL_SLOT_DELETED;
+        rpl_count--;
+    }
+}
+
+static void rpl_dispatch(const OSDynLoad_NotifyData &rpl, OSDynLoad_NotifyReason reason) {
+    if (!rpl.name) return;
+    auto name = rpl_basename(rpl.name);
+    auto hash = rpl_hash(name);
+
+    for (size_t i = 0; i < rpl_subscriber_count; i++) {
+        const auto &sub = rpl_subscribers[i];
+        if (sub.hash == hash && sub.name == name) sub.callback(rpl, reason);
+    }
+}
+
+static void rpl_notify(OSDynLoad_Module module, void *ctx, OSDynLoad_NotifyReason reason, OSDynLoad_NotifyData *rpl) {
+    if (!rpl) return;
+
+    if (reason == OS_DYNLOAD_NOTIFY_LOADED) {
+        rpl_index_add(*rpl);
+    } else {
+        rpl_index_remove(*rpl);
+    }
+
+    rpl_dispatch(*rpl, reason);
+}
+
+void rpl_index_init() {
+    rpl_index_deinit();
+
+    // fetch in small batches so this doesn't need to allocate
     int num_rpls = OSDynLoad_GetNumberOfRPLs();
-    if (!num_rpls)
-        return std::nullopt;
+    OSDynLoad_NotifyData rpls[8];
+    for (int first = 0; first < num_rpls; first += std::size(rpls)) {
+        int batch = std::min<int>(std::size(rpls), num_rpls - first);
+        if (!OSDynLoad_GetRPLInfo(first, batch, rpls))
+            break;
 
-    // allocates but we free it at return
-    std::vector<OSDynLoad_NotifyData> rpls(num_rpls);
-    if (!OSDynLoad_GetRPLInfo(0, num_rpls, rpls.data()))
-        return std::nullopt;
+        for (int i = 0; i < batch; i++) {
+            rpl_index_add(rpls[i]);
+        }
+    }
 
-    auto rpl = std::find_if(rpls.begin(), rpls.end(), [=](const OSDynLoad_NotifyData &rpl) {
-        return std::string_view(rpl.name).ends_with(name);
-    });
-    if (rpl == rpls.end())
-        return std::nullopt;
+    OSDynLoad_AddNotifyCallback(&rpl_notify, nullptr);
+    rpl_index_active = true;
+    DEBUG_FUNCTION_LINE_VERBOSE("Indexed %d RPLs", rpl_count);
+}
 
-    return *rpl;
+void rpl_index_replay() {
+    // let subscribers know about anything that beat us to it
+    for (const auto &slot: rpl_index) {
+        if (slot.hash > RPL_SLOT_DELETED) rpl_dispatch(slot.rpl, OS_DYNLOAD_NOTIFY_LOADED);
+    }
 }
 
-std::optional<uint16_t> get_current_title_version() {
-    const auto mcpHandle = MCP_Open();
-    MCPTitleListType titleInfo;
-    int32_t res = -1;
-    const uint64_t curTitleId = OSGetTitleID();
-    if ((curTitleId & 0x0000000F00000000) == 0) {
-        res = MCP_GetTitleInfo(mcpHandle, curTitleId | 0x0000000E00000000, &titleInfo);
+void rpl_index_deinit() {
+    if (rpl_index_active) {
+        OSDynLoad_DelNotifyCallback(&rpl_notify, nullptr);
+        rpl_index_active = false;
     }
-    if (res != 0) {
-        res = MCP_GetTitleInfo(mcpHandle, curTitleId, &titleInfo);
+
+    for (auto &slot: rpl_index) {
+        slot.hash = RPL_SLOT_EMPTY;
     }
-    MCP_Close(mcpHandle);
-    if (res != 0) {
-        DEBUG_FUNCTION_LINE("Failed to get title version of %016llX.", curTitleId);
-        return {};
+    rpl_count = 0;
+}
+
+bool rpl_subscribe(std::string_view name, rpl_notify_fn callback) {
+    if (rpl_subscriber_count == RPL_MAX_SUBSCRIBERS) {
+        DEBUG_FUNCTION_LINE("Too many RPL subscribers, can't watch %.*s!", (int) name.size(), name.data());
+        return false;
     }
-    MCP_Close(mcpHandle);
-    const auto tmp_result = titleInfo.titleVersion; // make the compiler happy because we access a packed struct
-    return tmp_result;
+
+    rpl_subscribers[rpl_subscriber_count++] = {rpl_hash(name), name, callback};
+    return true;
+}
+
+std::optional<OSDynLoad_NotifyData> find_main_rpx() {
+    for (const auto &slot: rpl_index) {
+        if (slot.hash <= RPL_SLOT_DELETED) continue;
+        if (rpl_basename(slot.rpl.name).ends_with(".rpx")) return slot.rpl;
+    }
+    return std::nullopt;
+}
+
+std::optional<OSDynLoad_NotifyData> search_for_rpl(std::string_view name) {
+    auto *slot = rpl_find_slot(rpl_hash(name), name);
+    if (!slot)
+        return std::nullopt;
+
+    return slot->rpl;
+}
+
+size_t collect_rpl_regions(std::span<mem_region> out) {
+    size_t count = 0;
+
+    for (const auto &slot: rpl_index) {
+        if (slot.hash <= RPL_SLOT_DELETED) continue;
+
+        for (auto region: {mem_region{slot.rpl.dataAddr, slot.rpl.dataSize},
+                           mem_region{slot.rpl.readAddr, slot.rpl.readSize}}) {
+            if (!region.start || !region.size) continue;
+            if (count == out.size()) return count;
+            out[count++] = region;
+        }
+    }
+
+    return count;
 }
@@ -14,17 +14,36 @@
 #pragma once
 
 #include <optional>
+#include <span>
 #include <string_view>
 #include <coreinit/dynload.h>
 
+#include "replace_mem.h"
+
+using rpl_notify_fn = void (*)(const OSDynLoad_NotifyData &rpl, OSDynLoad_NotifyReason reason);
+
+// (re)builds the index of loaded RPLs for the current process and starts tracking loads/unloads - once per app start
+void rpl_index_init();
+// sends LOADED to subscribers for everything already in the index - split from init so the title context can be
+// refreshed in between
+void rpl_index_replay();
+void rpl_index_deinit();
+
+// calls callback whenever an RPL with this file name (e.g. "nn_olv.rpl") loads or unloads, including from
+// rpl_index_replay() for a new process. Subscriptions last for the whole session; name must outlive them.
+bool rpl_subscribe(std::string_view name, rpl_notify_fn callback);
+
+// looks up a loaded RPL by file name (e.g. "Turbo.rpx") in the index, without asking the loader
 std::optional<OSDynLoad_NotifyData> search_for_rpl(std::string_view name);
+// the running title's executable, from the index
+std::optional<OSDynLoad_NotifyData> find_main_rpx();
+// writes the data and read-only data sections of every loaded RPL into out, returns how many were written
+size_t collect_rpl_regions(std::span<mem_region> out);
 
 constexpr void *rpl_addr(OSDynLoad_NotifyData rpl, uint32_t cemu_addr) {
     if (cemu_addr < 0x1000'0000) {
-        return (void *)(rpl.textAddr + cemu_addr - 0x0200'0000);
+        return (void *) (uintptr_t) (rpl.textAddr + cemu_addr - 0x0200'0000);
     } else {
-        return (void *)(rpl.dataAddr + cemu_addr - 0x1000'0000);
+        return (void *) (uintptr_t) (rpl.dataAddr + cemu_addr - 0x1000'0000);
     }
 }
-
-std::optional<uint16_t> get_current_title_version();
\ No newline at end of file
@@ -0,0 +1,101 @@
+/*  Copyright 2026 Pretendo Network contributors <pretendo.network>
+
+    Permission to use, copy, modify, and/or distribute this software for any purpose with or without fee is hereby
+    granted, provided that the above copyright notice and this permission notice appear in all copies.
+
+    THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES WITH REGARD TO THIS SOFTWARE INCLUDING ALL
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT,
+    INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER
+    IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR
+    PERFORMANCE OF THIS SOFTWARE.
+*/
+
+
+#include "sd_file.h"
+#include "logger.h"
+
+#include <coreinit/filesystem.h>
+#include <coreinit/mutex.h>
+
+#include <cstring>
+
+// FS wants 64-byte aligned buffers, and the callers' aren't always - so reads go through this a chunk at a time
+#define SD_FILE_CHUNK_SIZE 0x1000
+
+static FSClient client;
+static FSCmdBlock block;
+static bool client_ready = false;
+// the command block and the chunk are shared, and the Menu reads icons from more than one thread
+static OSMutex client_mutex;
+alignas(0x40) static uint8_t chunk[SD_FILE_CHUNK_SIZE];
+
+FILE *fopen_unbuffered(const char *path, const char *mode) {
+    FILE *file = fopen(path, mode);
+    if (file) setvbuf(file, nullptr, _IONBF, 0);
+    return file;
+}
+
+// FS paths are the fs:/ ones without the device name
+static const char *fs_path(const char *path) {
+    return strncmp(path, "fs:", 3) == 0 ? path + 3 : path;
+}
+
+static std::optional<size_t> read_open_file(const char *path, FSFileHandle handle, std::span<uint8_t> buffer) {
+    size_t size = 0;
+    while (true) {
+        const auto read = (int32_t) FSReadFile(&client, &block, chunk, 1, sizeof(chunk), handle, 0, FS_ERROR_FLAG_ALL);
+        if (read < 0) return std::nullopt;
+        if (read == 0) return size;
+        if (size + read > buffer.size()) {
+            DEBUG_FUNCTION_LINE("Inkay: %s is bigger than %u bytes", path, (unsigned) buffer.size());
+            return std::nullopt;
+        }
+        memcpy(buffer.data() + size, chunk, read);
+        size += read;
+    }
+}
+
+std::optional<size_t> read_whole_file(const char *path, std::span<uint8_t> buffer) {
+    if (!client_ready) return std::nullopt;
+
+    OSLockMutex(&client_mutex);
+    std::optional<size_t> size;
+    FSFileHandle handle;
+    if (FSOpenFile(&client, &block, fs_path(path), "r", &handle, FS_ERROR_FLAG_ALL) == FS_STATUS_OK) {
+        size = read_open_file(path, handle, buffer);
+        FSCloseFile(&client, &block, handle, FS_ERROR_FLAG_ALL);
+    }
+    OSUnlockMutex(&client_mutex);
+    return size;
+}
+
+bool sd_dir_exists(const char *path) {
+    if (!client_ready) return false;
+
+    OSLockMutex(&client_mutex);
+    FSStat stat;
+    const bool exists = FSGetStat(&client, &block, fs_path(path), &stat, FS_ERROR_FLAG_ALL) == FS_STATUS_OK &&
+                        (stat.flags & FS_STAT_DIRECTORY);
+    OSUnlockMutex(&client_mutex);
+    return exists;
+}
+
+void sd_file_process_start() {
+    if (client_ready) return;
+
+    OSInitMutex(&client_mutex);
+    FSInit();
+    client_ready = FSAddClient(&client, FS_ERROR_FLAG_ALL) == FS_STATUS_OK;
+    if (!client_ready) {
+        DEBUG_FUNCTION_LINE("Inkay: FSAddClient failed, can't read the SD card");
+        return;
+    }
+    FSInitCmdBlock(&block);
+}
+
+void sd_file_process_end() {
+    if (!client_ready) return;
+
+    client_ready = false;
+    FSDelClient(&client, FS_ERROR_FLAG_ALL);
+}
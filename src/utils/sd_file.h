@@ -0,0 +1,32 @@
+/*  Copyright 2026 Pretendo Network contributors <pretendo.network>
+
+    Permission to use, copy, modify, and/or distribute this software for any purpose with or without fee is hereby
+    granted, provided that the above copyright notice and this permission notice appear in all copies.
+
+    THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES WITH REGARD TO THIS SOFTWARE INCLUDING ALL
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT,
+    INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER
+    IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR
+    PERFORMANCE OF THIS SOFTWARE.
+*/
+
+
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+#include <optional>
+#include <span>
+
+// fopen without the stdio buffer newlib would malloc for every file - read and write in whole blocks instead
+FILE *fopen_unbuffered(const char *path, const char *mode);
+
+// reads all of path into buffer in one go. nullopt if it can't be opened or doesn't fit
+std::optional<size_t> read_whole_file(const char *path, std::span<uint8_t> buffer);
+// true if path is a directory
+bool sd_dir_exists(const char *path);
+
+// newlib's FILEs and the fs:/ devoptab both allocate on every open, so the reads above go through an FS client of our
+// own instead - added as each process starts, and gone before it ends. Writes still use stdio
+void sd_file_process_start();
+void sd_file_process_end();
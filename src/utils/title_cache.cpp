@@ -0,0 +1,145 @@
+/*  Copyright 2026 Pretendo Network contributors <pretendo.network>
+
+    Permission to use, copy, modify, and/or distribute this software for any purpose with or without fee is hereby
+    granted, provided that the above copyright notice and this permission notice appear in all copies.
+
+    THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES WITH REGARD TO THIS SOFTWARE INCLUDING ALL
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT,
+    INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER
+    IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR
+    PERFORMANCE OF THIS SOFTWARE.
+*/
+
+
+#include "title_cache.h"
+#include "logger.h"
+#include "sd_file.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+
+#define TITLE_CACHE_DIR "fs:/vol/external01/wiiu/inkay"
+#define TITLE_CACHE_PATH TITLE_CACHE_DIR "/title_cache.bin"
+#define TITLE_CACHE_MAGIC 0x494E4B43 // INKC
+#define TITLE_CACHE_ENTRIES 64
+
+struct title_cache_header {
+    uint32_t magic;
+    uint32_t build_hash;
+    uint32_t count;
+};
+
+static title_cache_entry entries[TITLE_CACHE_ENTRIES];
+static uint32_t entry_count = 0;
+// next slot to evict once the cache is full - oldest insert goes first
+static uint32_t next_evict = 0;
+static uint32_t build_hash = 0;
+static bool loaded = false;
+static bool dirty = false;
+
+static uint32_t hash_string(const char *str) {
+    uint32_t hash = 2166136261u;
+    for (; *str; str++) {
+        hash = (hash ^ (uint8_t) *str) * 16777619u;
+    }
+    return hash;
+}
+
+static bool sd_opted_in() {
+    return sd_dir_exists(TITLE_CACHE_DIR);
+}
+
+static void load_from_sd() {
+    if (!sd_opted_in()) return;
+
+    // the header, then the entries straight after it
+    static uint8_t file_data[sizeof(title_cache_header) + sizeof(entries)];
+    const auto size = read_whole_file(TITLE_CACHE_PATH, file_data);
+    if (!size) return;
+
+    title_cache_header header = {};
+    if (*size >= sizeof(header)) memcpy(&header, file_data, sizeof(header));
+    if (header.magic != TITLE_CACHE_MAGIC || header.build_hash != build_hash || header.count > TITLE_CACHE_ENTRIES) {
+        DEBUG_FUNCTION_LINE_VERBOSE("Inkay: ignoring stale title cache");
+        return;
+    }
+
+    entry_count = std::min<uint32_t>(header.count, (*size - sizeof(header)) / sizeof(title_cache_entry));
+    memcpy(entries, file_data + sizeof(header), entry_count * sizeof(title_cache_entry));
+    next_evict = entry_count % TITLE_CACHE_ENTRIES;
+
+    DEBUG_FUNCTION_LINE_VERBOSE("Inkay: loaded %u cached titles", (unsigned) entry_count);
+}
+
+void title_cache_init(const char *build) {
+    if (loaded) return;
+    loaded = true;
+
+    build_hash = hash_string(build);
+    load_from_sd();
+}
+
+void title_cache_flush() {
+    if (!dirty) return;
+    dirty = false;
+
+    if (!sd_opted_in()) return;
+
+    FILE *file = fopen_unbuffered(TITLE_CACHE_PATH, "wb");
+    if (!file) {
+        DEBUG_FUNCTION_LINE("Inkay: failed to open %s for writing", TITLE_CACHE_PATH);
+        return;
+    }
+
+    const title_cache_header header = {TITLE_CACHE_MAGIC, build_hash, entry_count};
+    if (fwrite(&header, sizeof(header), 1, file) != 1 ||
+        fwrite(entries, sizeof(title_cache_entry), entry_count, file) != entry_count) {
+        DEBUG_FUNCTION_LINE("Inkay: failed to write title cache");
+    }
+    fclose(file);
+}
+
+static title_cache_entry *find_entry(const title_context &title) {
+    if (!title.version) return nullptr;
+
+    for (uint32_t i = 0; i < entry_count; i++) {
+        auto &entry = entries[i];
+        if (entry.title_id == title.title_id && entry.version == *title.version) return &entry;
+    }
+    return nullptr;
+}
+
+const title_cache_entry *title_cache_find(const title_context &title) {
+    return find_entry(title);
+}
+
+void title_cache_set(const title_context &title, uint16_t flags, uint32_t olv_offset) {
+    if (!title.version) return;
+
+    auto *entry = find_entry(title);
+    if (!entry) {
+        if (entry_count < TITLE_CACHE_ENTRIES) {
+            entry = &entries[entry_count++];
+        } else {
+            entry = &entries[next_evict];
+            next_evict = (next_evict + 1) % TITLE_CACHE_ENTRIES;
+        }
+        *entry = {title.title_id, *title.version, 0, 0};
+    }
+
+    const auto new_offset = (flags & TITLE_CACHE_OLV_OFFSET) ? olv_offset : entry->olv_offset;
+    if ((entry->flags & flags) == flags && entry->olv_offset == new_offset) return;
+
+    entry->flags |= flags;
+    entry->olv_offset = new_offset;
+    dirty = true;
+}
+
+void title_cache_clear(const title_context &title, uint16_t flags) {
+    auto *entry = find_entry(title);
+    if (!entry || !(entry->flags & flags)) return;
+
+    entry->flags &= ~flags;
+    dirty = true;
+}
@@ -0,0 +1,45 @@
+/*  Copyright 2026 Pretendo Network contributors <pretendo.network>
+
+    Permission to use, copy, modify, and/or distribute this software for any purpose with or without fee is hereby
+    granted, provided that the above copyright notice and this permission notice appear in all copies.
+
+    THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES WITH REGARD TO THIS SOFTWARE INCLUDING ALL
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT,
+    INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER
+    IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR
+    PERFORMANCE OF THIS SOFTWARE.
+*/
+
+
+#pragma once
+
+#include "title_context.h"
+
+#include <cstdint>
+
+enum title_cache_flags : uint16_t {
+    TITLE_CACHE_NOTHING_TO_PATCH = 1 << 0, ///< last launch needed no start-time patches at all
+    TITLE_CACHE_OLV_OFFSET = 1 << 1,       ///< olv_offset holds where nn_olv's URL was last time
+};
+
+struct title_cache_entry {
+    uint64_t title_id;
+    uint16_t version;
+    uint16_t flags;
+    uint32_t olv_offset; ///< from the start of nn_olv's data section
+};
+
+/**
+ * Remembers what the last launch of a title (at a given version) needed, so repeat launches can skip straight to the
+ * answer. Lives in memory for the session, and on the SD card if fs:/vol/external01/wiiu/inkay/ exists.
+ *
+ * Titles MCP couldn't give a version for are never cached.
+ */
+// loads the SD copy on first use; build should change whenever the patches do, so stale results get dropped
+void title_cache_init(const char *build);
+// writes the SD copy if anything changed since the last flush
+void title_cache_flush();
+
+const title_cache_entry *title_cache_find(const title_context &title);
+void title_cache_set(const title_context &title, uint16_t flags, uint32_t olv_offset = 0);
+void title_cache_clear(const title_context &title, uint16_t flags);
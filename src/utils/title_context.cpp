@@ -0,0 +1,72 @@
+/*  Copyright 2026 Pretendo Network contributors <pretendo.network>
+
+    Permission to use, copy, modify, and/or distribute this software for any purpose with or without fee is hereby
+    granted, provided that the above copyright notice and this permission notice appear in all copies.
+
+    THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES WITH REGARD TO THIS SOFTWARE INCLUDING ALL
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT,
+    INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER
+    IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR
+    PERFORMANCE OF THIS SOFTWARE.
+*/
+
+#include "title_context.h"
+#include "rpl_info.h"
+#include "logger.h"
+#include "ipc_stats.h"
+
+#include <coreinit/mcp.h>
+#include <coreinit/title.h>
+
+#include <cstdio>
+
+static title_context current = {};
+
+static std::optional<uint16_t> query_title_version(uint64_t title_id) {
+    const auto mcpHandle = IPC_CALL(IPC_MCP, MCP_Open());
+    if (mcpHandle < 0) {
+        DEBUG_FUNCTION_LINE("Failed to open MCP: %d", mcpHandle);
+        return {};
+    }
+
+    MCPTitleListType titleInfo;
+    int32_t res = -1;
+    // prefer the update's version if there is one
+    if ((title_id & 0x0000000F00000000) == 0) {
+        res = IPC_CALL(IPC_MCP, MCP_GetTitleInfo(mcpHandle, title_id | 0x0000000E00000000, &titleInfo));
+    }
+    if (res != 0) {
+        res = IPC_CALL(IPC_MCP, MCP_GetTitleInfo(mcpHandle, title_id, &titleInfo));
+    }
+    IPC_CALL(IPC_MCP, MCP_Close(mcpHandle));
+
+    if (res != 0) {
+        DEBUG_FUNCTION_LINE("Failed to get title version of %016llX.", (unsigned long long) title_id);
+        return {};
+    }
+    const auto tmp_result = titleInfo.titleVersion; // make the compiler happy because we access a packed struct
+    return tmp_result;
+}
+
+void title_context_refresh() {
+    current = {};
+    current.title_id = OSGetTitleID();
+    current.version = query_title_version(current.title_id);
+
+    if (const auto rpx = find_main_rpx()) {
+        auto name = std::string_view(rpx->name);
+        name = name.substr(name.find_last_of("/\\") + 1);
+        snprintf(current.rpx_name, sizeof(current.rpx_name), "%.*s", (int) name.size(), name.data());
+
+        current.text = {rpx->textAddr, rpx->textSize};
+        current.data = {rpx->dataAddr, rpx->dataSize};
+        current.read = {rpx->readAddr, rpx->readSize};
+    }
+
+    DEBUG_FUNCTION_LINE_VERBOSE("Title %016llX v%d (%s)", current.title_id, current.version.value_or(0),
+                                current.rpx_name);
+}
+
+const title_context &current_title() {
+    return current;
+}
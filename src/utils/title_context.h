@@ -0,0 +1,49 @@
+/*  Copyright 2026 Pretendo Network contributors <pretendo.network>
+
+    Permission to use, copy, modify, and/or distribute this software for any purpose with or without fee is hereby
+    granted, provided that the above copyright notice and this permission notice appear in all copies.
+
+    THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES WITH REGARD TO THIS SOFTWARE INCLUDING ALL
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT,
+    INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER
+    IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR
+    PERFORMANCE OF THIS SOFTWARE.
+*/
+
+#pragma once
+
+#include "replace_mem.h"
+
+#include <cstdint>
+#include <optional>
+#include <string_view>
+
+/**
+ * Everything the patch modules want to know about the running title. Built once per title switch by
+ * title_context_refresh(), so asking for it is free no matter how many patches do.
+ */
+struct title_context {
+    uint64_t title_id;
+    std::optional<uint16_t> version; ///< empty if MCP couldn't tell us
+
+    char rpx_name[64];               ///< main executable's file name, e.g. "Turbo.rpx" - empty if not found
+    mem_region text;
+    mem_region data;
+    mem_region read;
+
+    std::string_view rpx() const { return rpx_name; }
+    bool has_rpx() const { return rpx_name[0] != '\0'; }
+};
+
+// rebuilds the snapshot for the current process - call once per application start, after rpl_index_init()
+void title_context_refresh();
+const title_context &current_title();
+
+// same idea as rpl_addr, but for the main executable
+constexpr void *rpx_addr(const title_context &title, uint32_t cemu_addr) {
+    if (cemu_addr < 0x1000'0000) {
+        return (void *) (uintptr_t) (title.text.start + cemu_addr - 0x0200'0000);
+    } else {
+        return (void *) (uintptr_t) (title.data.start + cemu_addr - 0x1000'0000);
+    }
+}
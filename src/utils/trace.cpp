@@ -0,0 +1,105 @@
+/*  Copyright 2026 Pretendo Network contributors <pretendo.network>
+
+    Permission to use, copy, modify, and/or distribute this software for any purpose with or without fee is hereby
+    granted, provided that the above copyright notice and this permission notice appear in all copies.
+
+    THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES WITH REGARD TO THIS SOFTWARE INCLUDING ALL
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT,
+    INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER
+    IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR
+    PERFORMANCE OF THIS SOFTWARE.
+*/
+
+
+#include "trace.h"
+
+#ifdef INKAY_TRACE
+
+#include "logger.h"
+#include "sd_file.h"
+
+#include <coreinit/core.h>
+#include <coreinit/time.h>
+
+#include <sys/stat.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+
+// not wiiu/inkay - creating that would opt into the title cache too
+#define TRACE_DIR "fs:/vol/external01/wiiu/inkay_trace"
+#define TRACE_PATH TRACE_DIR "/trace.bin"
+#define TRACE_OLD_PATH TRACE_DIR "/trace.old.bin"
+// 64Ki records - past this the current file becomes trace.old.bin, so the SD card holds at most twice this
+#define TRACE_MAX_FILE_SIZE 0x100000
+#define TRACE_MAGIC 0x494B5452 // IKTR
+#define TRACE_CORES 3
+// power of two, per core
+#define TRACE_RING_SIZE 256
+
+struct trace_ring {
+    // threads on the same core can still preempt each other, so claiming a slot has to be atomic
+    std::atomic<uint32_t> head;
+    uint32_t drained;
+    trace_record records[TRACE_RING_SIZE];
+};
+
+static trace_ring rings[TRACE_CORES];
+
+void trace(trace_event event, uint32_t a, uint32_t b) {
+    const auto core = OSGetCoreId() % TRACE_CORES;
+    auto &ring = rings[core];
+
+    const auto slot = ring.head.fetch_add(1, std::memory_order_relaxed) & (TRACE_RING_SIZE - 1);
+    ring.records[slot] = {(uint32_t) OSGetSystemTick(), event, (uint16_t) core, a, b};
+}
+
+// the trace file to append to, rotated if it's full - nullptr if the SD card isn't there
+static FILE *open_trace(bool &fresh) {
+    struct stat st;
+    if (stat(TRACE_DIR, &st) != 0 && mkdir(TRACE_DIR, 0777) != 0) return nullptr;
+
+    fresh = stat(TRACE_PATH, &st) != 0;
+    if (!fresh && st.st_size >= TRACE_MAX_FILE_SIZE) {
+        remove(TRACE_OLD_PATH);
+        fresh = rename(TRACE_PATH, TRACE_OLD_PATH) == 0;
+        if (!fresh) {
+            DEBUG_FUNCTION_LINE("Inkay: couldn't rotate %s, not tracing", TRACE_PATH);
+            return nullptr;
+        }
+    }
+    return fopen_unbuffered(TRACE_PATH, "ab");
+}
+
+void trace_drain() {
+    bool fresh = false;
+    FILE *file = open_trace(fresh);
+    if (file && fresh) {
+        const uint32_t magic = TRACE_MAGIC;
+        fwrite(&magic, sizeof(magic), 1, file);
+    }
+
+    for (auto &ring: rings) {
+        const uint32_t head = ring.head.load(std::memory_order_relaxed);
+        uint32_t first = ring.drained;
+        if (head - first > TRACE_RING_SIZE) {
+            DEBUG_FUNCTION_LINE_VERBOSE("Inkay: trace ring overflowed, lost %u records",
+                                        (unsigned) (head - first - TRACE_RING_SIZE));
+            first = head - TRACE_RING_SIZE;
+        }
+
+        // at most two runs, either side of the wrap
+        for (uint32_t i = first; i != head && file;) {
+            const uint32_t slot = i & (TRACE_RING_SIZE - 1);
+            const uint32_t run = std::min(head - i, TRACE_RING_SIZE - slot);
+            fwrite(&ring.records[slot], sizeof(trace_record), run, file);
+            i += run;
+        }
+        ring.drained = head;
+    }
+
+    if (file) fclose(file);
+}
+
+#endif
@@ -0,0 +1,60 @@
+/*  Copyright 2026 Pretendo Network contributors <pretendo.network>
+
+    Permission to use, copy, modify, and/or distribute this software for any purpose with or without fee is hereby
+    granted, provided that the above copyright notice and this permission notice appear in all copies.
+
+    THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES WITH REGARD TO THIS SOFTWARE INCLUDING ALL
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT,
+    INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER
+    IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR
+    PERFORMANCE OF THIS SOFTWARE.
+*/
+
+
+#pragma once
+
+#include <cstdint>
+
+/**
+ * Binary trace for hook paths, where a formatted log line per call is too expensive. Only built in with TRACE=1 -
+ * otherwise every trace point compiles away. A trace point is a handful of stores into a per-core ring, nothing is
+ * formatted on the console. trace_drain() appends the rings to fs:/vol/external01/wiiu/inkay_trace/trace.bin,
+ * moving it to trace.old.bin once it gets big, and tools/decode_trace.py turns them into text.
+ *
+ * New events go at the end, the decoder reads their names out of this enum.
+ */
+enum trace_event : uint16_t {
+    TRACE_DNS_REPLACED,    ///< a: index into dns_replacements
+    TRACE_NEX_ATTRIBUTE,   ///< a: attribute index, b: rewritten value
+    TRACE_SCAN_MATCH,      ///< a: needle index, b: address
+    TRACE_CA_REPLACED,     ///< a: hook (TRACE_HOOK_*), b: size * count of the read
+    TRACE_IDBE_HIT,        ///< a: low half of the title ID, b: version
+};
+
+enum trace_hook : uint32_t {
+    TRACE_HOOK_ESHOP,
+    TRACE_HOOK_OLV,
+    TRACE_HOOK_ACCOUNT,
+};
+
+struct trace_record {
+    uint32_t tick;  ///< OSGetSystemTick
+    uint16_t event;
+    uint16_t core;
+    uint32_t a;
+    uint32_t b;
+};
+
+#ifdef INKAY_TRACE
+
+void trace(trace_event event, uint32_t a = 0, uint32_t b = 0);
+
+// copies out everything traced since the last drain - call from somewhere that isn't a hook
+void trace_drain();
+
+#else
+
+inline void trace(trace_event event, uint32_t a = 0, uint32_t b = 0) {}
+inline void trace_drain() {}
+
+#endif
@@ -0,0 +1,863 @@
+/*  Copyright 2026 Pretendo Network contributors <pretendo.network>
+
+    Permission to use, copy, modify, and/or distribute this software for any purpose with or without fee is hereby
+    granted, provided that the above copyright notice and this permission notice appear in all copies.
+
+    THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES WITH REGARD TO THIS SOFTWARE INCLUDING ALL
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT,
+    INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER
+    IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR
+    PERFORMANCE OF THIS SOFTWARE.
+*/
+
+/**
+ * Runs the whole module on the host against the mocks: the WUMS lifecycle, title switches, RPL notifications, the FS,
+ * DNS and NEX hooks, and network switches, in the order a console session would produce them. Every scenario checks
+ * what the module did to the fake console, and the last one times each hook against calling the original directly.
+ *
+ *   hook_harness [--calls n]
+ */
+
+#include "cafe.h"
+
+#include "config.h"
+#include "export.h"
+#include "heap_walk.h"
+#include "hook_stats.h"
+#include "iosu_url_patches.h"
+#include "lang.h"
+#include "olv_urls.h"
+#include "patch_txn.h"
+
+#include <coreinit/filesystem.h>
+#include <coreinit/memexpheap.h>
+#include <coreinit/thread.h>
+
+#include <netdb.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+#include "ca_pem.h"
+
+#define HARNESS_SERIAL "FW412345678"
+// 50000 + serial digits 4-7 of the serial MCP reports, which starts after the 2 character code
+#define HARNESS_P2P_PORT 54567
+
+#define MK8_TID 0x000500001010EC00ull
+#define MENU_TID 0x0005001010040200ull
+#define MIIVERSE_TID 0x000500301001610Aull
+#define ACCOUNT_SETTINGS_TID 0x000500101004B100ull
+#define OTHER_TID 0x0005000010101D00ull
+
+// where the fake titles live - the data sections are in MEM2 like a real title's
+#define RPX_TEXT 0x02000000u
+#define RPX_DATA 0x10000000u
+#define RPX_DATA_SIZE 0x00200000u
+#define OLV_DATA 0x10400000u
+#define OLV_DATA_SIZE 0x00080000u
+#define OLV_URL_OFFSET 0x1230u
+#define APPLET_ALLOWLIST 0x10600000u
+#define JUXT_COLOUR 0x11800000u
+#define TEST_HEAP 0x30000000u
+#define TEST_HEAP_SIZE 0x00100000u
+
+#define FAKE_CA_HANDLE 7u
+#define FAKE_OTHER_HANDLE 8u
+// the applet's own rootca.pem is bigger than our bundle, and it reads that much
+#define FAKE_CA_DISK_SIZE (ca_pem_size + 0x2345u)
+#define CA_READ_CHUNK 0x1000u
+
+static int failures = 0;
+
+static void check(bool ok, const char *what, int line) {
+    if (ok) return;
+    fprintf(stderr, "hook_harness.cpp:%d: check failed: %s\n", line, what);
+    failures++;
+}
+#define CHECK(cond) check((cond), #cond, __LINE__)
+
+static void scenario(const char *name, void (*fn)()) {
+    const int before = failures;
+    fn();
+    printf("%-32s %s\n", name, failures == before ? "ok" : "FAIL");
+    fflush(stdout);
+}
+
+template <typename T>
+static T module_export(const char *name) {
+    auto *fn = mock_wums_export(name);
+    if (!fn) {
+        fprintf(stderr, "hook_harness: the module doesn't export %s\n", name);
+        abort();
+    }
+    return (T) fn;
+}
+
+template <typename T>
+static T hook(const char *function_name, FunctionPatcherTargetProcess process) {
+    return (T) mock_fp_hook(function_name, process);
+}
+
+static void write_file(const char *path, const void *data, size_t size) {
+    FILE *file = fopen(path, "wb");
+    if (!file || fwrite(data, 1, size, file) != size) {
+        perror(path);
+        abort();
+    }
+    fclose(file);
+}
+
+// the "originals" the hooks call through to
+
+static std::atomic<uint32_t> fs_reads = 0;
+
+static int fake_FSOpenFile(FSClient *client, FSCmdBlock *block, char *path, const char *mode, uint32_t *handle,
+                           int error) {
+    if (strcmp(path, "vol/content/browser/rootca.pem") == 0) {
+        *handle = FAKE_CA_HANDLE;
+        return FS_STATUS_OK;
+    }
+    *handle = FAKE_OTHER_HANDLE;
+    return FS_STATUS_OK;
+}
+
+static FSStatus fake_FSReadFile(FSClient *client, FSCmdBlock *block, uint8_t *buffer, uint32_t size, uint32_t count,
+                                FSFileHandle handle, uint32_t unk1, uint32_t flags) {
+    fs_reads++;
+    memset(buffer, 'F', size * count);
+    return (FSStatus) count;
+}
+
+static FSStatus fake_FSCloseFile(FSClient *client, FSCmdBlock *block, FSFileHandle handle, FSErrorFlag errorMask) {
+    return FS_STATUS_OK;
+}
+
+static thread_local const char *resolved_name;
+
+static hostent *fake_gethostbyname(const char *name) {
+    resolved_name = name;
+    return nullptr;
+}
+
+static int fake_getaddrinfo(const char *node, const char *service, const addrinfo *hints, addrinfo **res) {
+    resolved_name = node;
+    return 0;
+}
+
+static thread_local uint32_t nex_index;
+static thread_local uint32_t nex_value;
+
+static void fake_SetAttribute(void *_this, uint32_t attributeIndex, uint32_t attributeValue) {
+    nex_index = attributeIndex;
+    nex_value = attributeValue;
+}
+
+static uint32_t icon_downloads;
+
+static bool fake_DownloadIconFile(void *buffer, uint64_t title_id, uint16_t version, bool ctr) {
+    icon_downloads++;
+    memset(buffer, 'I', 0x40);
+    return true;
+}
+
+using fs_open_fn = decltype(&fake_FSOpenFile);
+using fs_read_fn = decltype(&fake_FSReadFile);
+using fs_close_fn = decltype(&fake_FSCloseFile);
+using gethostbyname_fn = decltype(&fake_gethostbyname);
+using getaddrinfo_fn = decltype(&fake_getaddrinfo);
+using set_attribute_fn = decltype(&fake_SetAttribute);
+using download_icon_fn = decltype(&fake_DownloadIconFile);
+
+// the fake console
+
+// same layout as the one in olv_applet.cpp
+struct olv_allowlist {
+    char scheme[16];
+    char domain[128];
+    char path[128];
+    unsigned char flags[5];
+};
+static constexpr olv_allowlist olv_original_entry = {"https", ".nintendo.net", "", {1, 1, 1, 1, 1}};
+static constexpr olv_allowlist olv_new_entry = {"https", "." NETWORK_BASEURL, "", {1, 1, 1, 1, 1}};
+
+static constexpr unsigned char miiverse_green_highlight[] = {
+        0x82, 0xff, 0x05, 0xff, 0x82, 0xff, 0x05, 0xff, 0x1d, 0xff, 0x04, 0xff, 0x1d, 0xff, 0x04, 0xff,
+};
+static constexpr unsigned char juxt_purple_highlight[] = {
+        0x5d, 0x4a, 0x9a, 0xff, 0x5d, 0x4a, 0x9a, 0xff, 0x5d, 0x4a, 0x9a, 0xff, 0x5d, 0x4a, 0x9a, 0xff,
+};
+
+static bool memory_is(uint32_t addr, const void *data, size_t size) {
+    return memcmp((const void *) (uintptr_t) addr, data, size) == 0;
+}
+
+static void place(uint32_t addr, const void *data, size_t size) {
+    memcpy((void *) (uintptr_t) addr, data, size);
+}
+
+static OSDynLoad_NotifyData rpl(const char *name, uint32_t text, uint32_t data, uint32_t data_size) {
+    OSDynLoad_NotifyData rpl = {};
+    rpl.name = (char *) name;
+    rpl.textAddr = text;
+    rpl.textSize = 0x1000;
+    rpl.dataAddr = data;
+    rpl.dataSize = data_size;
+    return rpl;
+}
+
+static OSDynLoad_NotifyData olv_rpl() {
+    return rpl("/vol/storage_mlc01/sys/title/00050010/1000400a/code/nn_olv.rpl", 0x03000000, OLV_DATA, OLV_DATA_SIZE);
+}
+
+// a fresh process for this title, with these RPLs already loaded - then the module's start-up hooks
+static void start_title(uint64_t title_id, std::optional<uint16_t> version,
+                        std::initializer_list<OSDynLoad_NotifyData> rpls) {
+    mock_set_title(title_id, version);
+    mock_rpl_reset(rpls.begin(), rpls.size());
+    wums_application_starts();
+    // the plugin checks in from its own application start hook
+    module_export<void (*)()>("Inkay_SetPluginRunning")();
+    wums_all_application_starts_done();
+}
+
+static void end_title() {
+    wums_application_ends();
+    // nothing the module started may outlive the process
+    CHECK(mock_threads_alive() == 0);
+    // the title's memory goes with it
+    mock_clear(RPX_TEXT, 0x01000000);
+    mock_clear(RPX_DATA, 0x04000000);
+}
+
+// scenarios, in session order
+
+static const URL_Patch &last_url_patch() {
+    return url_patches[std::size(url_patches) - 1];
+}
+
+static bool last_url_patched() {
+    uint32_t word;
+    memcpy(&word, last_url_patch().url, sizeof(word));
+    return mock_iosu_read(last_url_patch().address) == word;
+}
+
+static void initialize() {
+    mock_fp_original("FSOpenFile", (void *) &fake_FSOpenFile);
+    mock_fp_original("FSReadFile", (void *) &fake_FSReadFile);
+    mock_fp_original("FSCloseFile", (void *) &fake_FSCloseFile);
+    mock_fp_original("gethostbyname", (void *) &fake_gethostbyname);
+    mock_fp_original("getaddrinfo", (void *) &fake_getaddrinfo);
+    mock_fp_original("nex_MatchmakeSession_SetAttribute", (void *) &fake_SetAttribute);
+    mock_fp_original("nex_MatchmakeSessionSearchCriteria_SetAttribute", (void *) &fake_SetAttribute);
+    mock_fp_original("DownloadIconFile__Q2_2nn4idbeFPvULUsb", (void *) &fake_DownloadIconFile);
+    mock_set_console(HARNESS_SERIAL, {5, 5, 6, 'E'}, 1);
+
+    wums_initialize();
+    // the plugin initializes the module as the Wii U Menu starts, between the two WUMS hooks
+    mock_set_title(MENU_TID, 0);
+    mock_rpl_reset(nullptr, 0);
+    wums_application_starts();
+    module_export<void (*)()>("Inkay_SetPluginRunning")();
+    // the last URL's first word can't be read, so the journal starts out incomplete - network_switch checks that it's
+    // recorded again rather than reapplied without it
+    mock_iosu_fail_access(last_url_patch().address);
+    module_export<void (*)(bool, bool, inkay_language)>("Inkay_Initialize")(true, true, English);
+    wums_all_application_starts_done();
+
+    CHECK(Config::initialized);
+    CHECK(Config::connect_to_network);
+    CHECK(module_export<InkayStatus (*)()>("Inkay_GetStatus")() == InkayStatus::Pretendo);
+    // the SSL patch for 5.5.5+ and the URL table
+    CHECK(mock_iosu_read(0xE1019F78) == 0xE3A00001);
+    CHECK(mock_iosu_writes() > 100);
+    CHECK(hook<void *>("getaddrinfo", FP_TARGET_PROCESS_GAME_AND_MENU));
+    CHECK(hook<void *>("FSOpenFile", FP_TARGET_PROCESS_MIIVERSE));
+    CHECK(hook<void *>("FSOpenFile", FP_TARGET_PROCESS_ESHOP));
+    CHECK(hook<void *>("FSOpenFile", FP_TARGET_PROCESS_GAME));
+    CHECK(hook<void *>("nex_MatchmakeSession_SetAttribute", FP_TARGET_PROCESS_GAME));
+    end_title();
+    // the toast went out before the Menu's process ended
+    CHECK(mock_notification_count() == 1);
+}
+
+static void title_switches() {
+    // what the budget in main.cpp promises: MCP for the version and nothing else, however often it happens
+    const auto installed = mock_fp_installed();
+    for (int i = 0; i < 50; i++) {
+        const auto mcp = mock_mcp_calls();
+        const auto iosu = mock_iosu_writes();
+        start_title(i % 2 ? OTHER_TID : 0x0005000010145D00ull, i % 3 ? std::optional<uint16_t>(16) : std::nullopt,
+                    {rpl("game.rpx", RPX_TEXT, RPX_DATA, RPX_DATA_SIZE)});
+        CHECK(mock_mcp_calls() - mcp <= 4);
+        CHECK(mock_iosu_writes() == iosu);
+        CHECK(mock_fp_installed() == installed);
+        // one FS client for the title's SD reads, and it goes with the process
+        CHECK(mock_fs_clients() == 1);
+        end_title();
+        CHECK(mock_fs_clients() == 0);
+    }
+    // nothing new to say after the first one
+    CHECK(mock_notification_count() == 1);
+}
+
+static void rpl_notifications() {
+    // nn_olv loads after the title started
+    start_title(OTHER_TID, 16, {rpl("game.rpx", RPX_TEXT, RPX_DATA, RPX_DATA_SIZE)});
+    place(OLV_DATA + OLV_URL_OFFSET, original_url, sizeof(original_url));
+    mock_rpl_load(olv_rpl());
+    CHECK(memory_is(OLV_DATA + OLV_URL_OFFSET, new_url, sizeof(new_url)));
+
+    // unloaded and loaded again, fresh from disk - the cached offset finds it
+    mock_rpl_unload(olv_rpl().name);
+    place(OLV_DATA + OLV_URL_OFFSET, original_url, sizeof(original_url));
+    mock_rpl_load(olv_rpl());
+    CHECK(memory_is(OLV_DATA + OLV_URL_OFFSET, new_url, sizeof(new_url)));
+    end_title();
+
+    // and loaded before the title started, so it's only seen through the index replay
+    place(OLV_DATA + OLV_URL_OFFSET, original_url, sizeof(original_url));
+    start_title(OTHER_TID, 16, {rpl("game.rpx", RPX_TEXT, RPX_DATA, RPX_DATA_SIZE), olv_rpl()});
+    CHECK(memory_is(OLV_DATA + OLV_URL_OFFSET, new_url, sizeof(new_url)));
+
+    // somewhere else this time, so the cached offset misses and it scans
+    end_title();
+    auto moved = olv_rpl();
+    moved.dataAddr += 0x10000;
+    place(moved.dataAddr + 0x40, original_url, sizeof(original_url));
+    start_title(OTHER_TID, 16, {rpl("game.rpx", RPX_TEXT, RPX_DATA, RPX_DATA_SIZE), moved});
+    CHECK(memory_is(moved.dataAddr + 0x40, new_url, sizeof(new_url)));
+    end_title();
+}
+
+// reads the CA through whichever hooks serve this process, in the applet's chunk size
+static void read_rootca(FunctionPatcherTargetProcess process) {
+    auto open = hook<fs_open_fn>("FSOpenFile", process);
+    auto read = hook<fs_read_fn>("FSReadFile", process);
+    auto close = hook<fs_close_fn>("FSCloseFile", process);
+    CHECK(open && read && close);
+    if (!open || !read || !close) return;
+
+    FSClient client;
+    FSCmdBlock block;
+    uint32_t handle = 0;
+    char path[] = "vol/content/browser/rootca.pem";
+    CHECK(open(&client, &block, path, "r", &handle, -1) == FS_STATUS_OK);
+    CHECK(handle == FAKE_CA_HANDLE);
+
+    std::vector<uint8_t> file(FAKE_CA_DISK_SIZE + CA_READ_CHUNK, 0xAA);
+    const auto reads = fs_reads.load();
+    for (uint32_t offset = 0; offset < FAKE_CA_DISK_SIZE; offset += CA_READ_CHUNK) {
+        CHECK(read(&client, &block, &file[offset], 1, CA_READ_CHUNK, handle, 0, -1) == (int) CA_READ_CHUNK);
+    }
+    // something else open at the same time still gets read from disk
+    uint8_t other[16];
+    CHECK(read(&client, &block, other, 1, sizeof(other), FAKE_OTHER_HANDLE, 0, -1) == (int) sizeof(other));
+    CHECK(other[0] == 'F');
+    CHECK(fs_reads - reads == 1);
+    close(&client, &block, handle, FS_ERROR_FLAG_ALL);
+
+    CHECK(memcmp(file.data(), ca_pem, ca_pem_size) == 0);
+    bool padded = true;
+    for (uint32_t i = ca_pem_size; i < FAKE_CA_DISK_SIZE; i++) {
+        padded &= file[i] == 0;
+    }
+    CHECK(padded);
+
+    // closed, so the handle is the applet's again
+    CHECK(read(&client, &block, other, 1, sizeof(other), FAKE_CA_HANDLE, 0, -1) == (int) sizeof(other));
+    CHECK(other[0] == 'F');
+}
+
+static void miiverse_applet() {
+    place(OLV_DATA + OLV_URL_OFFSET, original_url, sizeof(original_url));
+    place(APPLET_ALLOWLIST, &olv_original_entry, sizeof(olv_original_entry));
+    place(JUXT_COLOUR, miiverse_green_highlight, sizeof(miiverse_green_highlight));
+    start_title(MIIVERSE_TID, 16, {rpl("miiverse.rpx", RPX_TEXT, RPX_DATA, RPX_DATA_SIZE), olv_rpl()});
+
+    auto open = hook<fs_open_fn>("FSOpenFile", FP_TARGET_PROCESS_MIIVERSE);
+    FSClient client;
+    FSCmdBlock block;
+    uint32_t handle;
+    char initial_oma[] = "vol/content/initial.oma";
+    CHECK(open && open(&client, &block, initial_oma, "r", &handle, -1) == FS_STATUS_OK);
+    CHECK(memory_is(APPLET_ALLOWLIST, &olv_new_entry, sizeof(olv_new_entry)));
+
+    // the first CA read starts the recolor in the background
+    read_rootca(FP_TARGET_PROCESS_MIIVERSE);
+    for (int waited = 0; waited < 3000 && !memory_is(JUXT_COLOUR, juxt_purple_highlight, 16); waited += 10) {
+        usleep(10000);
+    }
+    CHECK(memory_is(JUXT_COLOUR, juxt_purple_highlight, sizeof(juxt_purple_highlight)));
+
+    // the applet reloading its content is a new session in the same process, and recolors again
+    place(JUXT_COLOUR, miiverse_green_highlight, sizeof(miiverse_green_highlight));
+    CHECK(open(&client, &block, initial_oma, "r", &handle, -1) == FS_STATUS_OK);
+    read_rootca(FP_TARGET_PROCESS_MIIVERSE);
+    for (int waited = 0; waited < 3000 && !memory_is(JUXT_COLOUR, juxt_purple_highlight, 16); waited += 10) {
+        usleep(10000);
+    }
+    CHECK(memory_is(JUXT_COLOUR, juxt_purple_highlight, sizeof(juxt_purple_highlight)));
+    // and the applet going away has to wait for it
+    end_title();
+
+    // a second session ending straight away - the thread gives up rather than outliving the applet
+    place(JUXT_COLOUR, miiverse_green_highlight, sizeof(miiverse_green_highlight));
+    start_title(MIIVERSE_TID, 16, {rpl("miiverse.rpx", RPX_TEXT, RPX_DATA, RPX_DATA_SIZE), olv_rpl()});
+    read_rootca(FP_TARGET_PROCESS_MIIVERSE);
+    end_title();
+}
+
+static void eshop_and_account_settings() {
+    start_title(0x0005003010017100ull, 16, {rpl("eshop.rpx", RPX_TEXT, RPX_DATA, RPX_DATA_SIZE)});
+    read_rootca(FP_TARGET_PROCESS_ESHOP);
+    end_title();
+
+    start_title(ACCOUNT_SETTINGS_TID, 16, {rpl("account.rpx", RPX_TEXT, RPX_DATA, RPX_DATA_SIZE)});
+    read_rootca(FP_TARGET_PROCESS_GAME);
+    end_title();
+
+    // any other game has its CA left alone
+    start_title(OTHER_TID, 16, {rpl("game.rpx", RPX_TEXT, RPX_DATA, RPX_DATA_SIZE)});
+    auto open = hook<fs_open_fn>("FSOpenFile", FP_TARGET_PROCESS_GAME);
+    auto read = hook<fs_read_fn>("FSReadFile", FP_TARGET_PROCESS_GAME);
+    FSClient client;
+    FSCmdBlock block;
+    uint32_t handle;
+    uint8_t buffer[16];
+    char path[] = "vol/content/browser/rootca.pem";
+    CHECK(open(&client, &block, path, "r", &handle, -1) == FS_STATUS_OK);
+    CHECK(read(&client, &block, buffer, 1, sizeof(buffer), handle, 0, -1) == (int) sizeof(buffer));
+    CHECK(buffer[0] == 'F');
+    end_title();
+}
+
+struct resolver_thread {
+    OSThread thread;
+    std::atomic<uint32_t> *mismatches;
+    uint32_t calls;
+};
+
+static int resolver_main(int argc, const char **argv) {
+    auto *self = (resolver_thread *) argv;
+    auto ghbn = hook<gethostbyname_fn>("gethostbyname", FP_TARGET_PROCESS_GAME_AND_MENU);
+    auto gai = hook<getaddrinfo_fn>("getaddrinfo", FP_TARGET_PROCESS_GAME_AND_MENU);
+
+    static constexpr struct {
+        const char *name;
+        const char *expected;
+    } lookups[] = {
+            {"nncs1.app.nintendowifi.net", "nncs1.app." NETWORK_BASEURL},
+            {"nncs2.app.nintendowifi.net", "nncs2.app." NETWORK_BASEURL},
+            {"account.nintendo.net", "account.nintendo.net"},
+            {"nncs3.app.nintendowifi.net", "nncs3.app.nintendowifi.net"},
+    };
+
+    uint32_t mismatches = 0;
+    for (uint32_t i = 0; i < self->calls; i++) {
+        const auto &lookup = lookups[i % std::size(lookups)];
+        resolved_name = nullptr;
+        if (i & 4) {
+            ghbn(lookup.name);
+        } else {
+            addrinfo *res;
+            gai(lookup.name, "443", nullptr, &res);
+        }
+        mismatches += !resolved_name || strcmp(resolved_name, lookup.expected) != 0;
+
+        // service-only lookups have no node at all
+        resolved_name = "";
+        addrinfo *res;
+        gai(nullptr, "443", nullptr, &res);
+        mismatches += resolved_name != nullptr;
+    }
+    *self->mismatches += mismatches;
+    return 0;
+}
+
+static void concurrent_resolver() {
+    static resolver_thread threads[8];
+    std::atomic<uint32_t> mismatches = 0;
+#ifdef HOOK_STATS
+    const auto ghbn_before = hook_stats_calls(HOOK_GETHOSTBYNAME);
+    const auto gai_before = hook_stats_calls(HOOK_GETADDRINFO);
+#endif
+
+    for (auto &thread: threads) {
+        thread.mismatches = &mismatches;
+        thread.calls = 20000;
+        CHECK(OSCreateThread(&thread.thread, resolver_main, 0, (char *) &thread, nullptr, 0, 16,
+                             OS_THREAD_ATTRIB_AFFINITY_ANY));
+        OSResumeThread(&thread.thread);
+    }
+    for (auto &thread: threads) {
+        OSJoinThread(&thread.thread, nullptr);
+    }
+    CHECK(mismatches == 0);
+#ifdef HOOK_STATS
+    // every call counted, however the threads landed on the cores. half the named lookups go through gethostbyname,
+    // the rest and every service-only lookup through getaddrinfo
+    CHECK(hook_stats_calls(HOOK_GETHOSTBYNAME) - ghbn_before == std::size(threads) * 20000 / 2);
+    CHECK(hook_stats_calls(HOOK_GETADDRINFO) - gai_before == std::size(threads) * 20000 * 3 / 2);
+    // and a dump starts the count again
+    hook_stats_dump();
+    CHECK(hook_stats_calls(HOOK_GETHOSTBYNAME) == 0 && hook_stats_calls(HOOK_GETADDRINFO) == 0);
+#endif
+}
+
+static void matchmaking_and_p2p() {
+    const char ini[] = "[pretendo]\n"
+                       "name = Harness Pack\n"
+                       "dlc_id = 2a\n"
+                       "[attributes]\n"
+                       "1 = -1\n"
+                       "2 = 1234\n";
+    write_file("fs:/vol/content/pretendo.ini", ini, sizeof(ini) - 1);
+
+    const uint16_t min_port = 0xc000, max_port = 0xffff;
+    place(RPX_DATA + 0x1a9a52, &min_port, sizeof(min_port));
+    place(RPX_DATA + 0x1a9a54, &max_port, sizeof(max_port));
+    start_title(MK8_TID, 81, {rpl("Turbo.rpx", RPX_TEXT, RPX_DATA, RPX_DATA_SIZE)});
+
+    auto session = hook<set_attribute_fn>("nex_MatchmakeSession_SetAttribute", FP_TARGET_PROCESS_GAME);
+    auto search = hook<set_attribute_fn>("nex_MatchmakeSessionSearchCriteria_SetAttribute", FP_TARGET_PROCESS_GAME);
+    CHECK(session && search);
+    session(nullptr, 4, 0);
+    CHECK(nex_index == 4 && nex_value == 0x2a);
+    search(nullptr, 2, 5);
+    CHECK(nex_index == 2 && nex_value == 0x1234);
+    session(nullptr, 1, 7);
+    CHECK(nex_value == 7);
+    search(nullptr, 9, 3);
+    CHECK(nex_index == 9 && nex_value == 3);
+
+    CHECK(*(uint16_t *) (uintptr_t) (RPX_DATA + 0x1a9a52) == HARNESS_P2P_PORT);
+    CHECK(*(uint16_t *) (uintptr_t) (RPX_DATA + 0x1a9a54) == HARNESS_P2P_PORT);
+    end_title();
+    unlink("fs:/vol/content/pretendo.ini");
+
+    // another version gets neither
+    place(RPX_DATA + 0x1a9a52, &min_port, sizeof(min_port));
+    place(RPX_DATA + 0x1a9a54, &max_port, sizeof(max_port));
+    start_title(MK8_TID, 64, {rpl("Turbo.rpx", RPX_TEXT, RPX_DATA, RPX_DATA_SIZE)});
+    CHECK(*(uint16_t *) (uintptr_t) (RPX_DATA + 0x1a9a52) == min_port);
+    session(nullptr, 4, 0);
+    CHECK(nex_value == 0);
+    end_title();
+}
+
+static void network_switch() {
+    auto set_network = module_export<uint32_t (*)(bool)>("Inkay_SetNetwork");
+
+    const uint16_t min_port = 0xc000, max_port = 0xffff;
+    place(RPX_DATA + 0x1a9a52, &min_port, sizeof(min_port));
+    place(RPX_DATA + 0x1a9a54, &max_port, sizeof(max_port));
+    place(OLV_DATA + OLV_URL_OFFSET, original_url, sizeof(original_url));
+    start_title(MK8_TID, 81, {rpl("Turbo.rpx", RPX_TEXT, RPX_DATA, RPX_DATA_SIZE), olv_rpl()});
+    CHECK(*(uint16_t *) (uintptr_t) (RPX_DATA + 0x1a9a52) == HARNESS_P2P_PORT);
+    CHECK(memory_is(OLV_DATA + OLV_URL_OFFSET, new_url, sizeof(new_url)));
+
+    // everything journalled comes back out of the running title
+    CHECK(set_network(false) == INKAY_RELAUNCH_NONE);
+    CHECK(!Config::connect_to_network);
+    CHECK(mock_fp_installed() == 0);
+    CHECK(mock_iosu_read(0xE1019F78) == 0);
+    CHECK(*(uint16_t *) (uintptr_t) (RPX_DATA + 0x1a9a52) == min_port);
+    CHECK(*(uint16_t *) (uintptr_t) (RPX_DATA + 0x1a9a54) == max_port);
+    CHECK(memory_is(OLV_DATA + OLV_URL_OFFSET, original_url, sizeof(original_url)));
+    CHECK(set_network(false) == INKAY_RELAUNCH_NONE);
+    end_title();
+
+    // Nintendo Network titles are left alone
+    place(RPX_DATA + 0x1a9a52, &min_port, sizeof(min_port));
+    place(OLV_DATA + OLV_URL_OFFSET, original_url, sizeof(original_url));
+    start_title(MK8_TID, 81, {rpl("Turbo.rpx", RPX_TEXT, RPX_DATA, RPX_DATA_SIZE), olv_rpl()});
+    CHECK(*(uint16_t *) (uintptr_t) (RPX_DATA + 0x1a9a52) == min_port);
+    CHECK(memory_is(OLV_DATA + OLV_URL_OFFSET, original_url, sizeof(original_url)));
+
+    // an IOSU write failing rolls the whole set back
+    const auto installed_before = mock_fp_installed();
+    mock_iosu_fail_access(last_url_patch().address);
+    CHECK(set_network(true) == INKAY_RELAUNCH_UNSUPPORTED);
+    CHECK(!Config::connect_to_network);
+    CHECK(mock_iosu_read(0xE1019F78) == 0);
+    CHECK(mock_fp_installed() == installed_before);
+
+    // and switching back puts the IOSU patches and hooks back, but leaves the running title for its next launch
+    CHECK(set_network(true) == INKAY_RELAUNCH_RUNNING_TITLE);
+    CHECK(Config::connect_to_network);
+    CHECK(mock_iosu_read(0xE1019F78) == 0xE3A00001);
+    CHECK(last_url_patched());
+    CHECK(mock_fp_installed() > installed_before);
+    CHECK(*(uint16_t *) (uintptr_t) (RPX_DATA + 0x1a9a52) == min_port);
+    CHECK(memory_is(OLV_DATA + OLV_URL_OFFSET, original_url, sizeof(original_url)));
+    end_title();
+
+    // the next launch is patched
+    place(RPX_DATA + 0x1a9a52, &min_port, sizeof(min_port));
+    place(RPX_DATA + 0x1a9a54, &max_port, sizeof(max_port));
+    place(OLV_DATA + OLV_URL_OFFSET, original_url, sizeof(original_url));
+    start_title(MK8_TID, 81, {rpl("Turbo.rpx", RPX_TEXT, RPX_DATA, RPX_DATA_SIZE), olv_rpl()});
+    CHECK(*(uint16_t *) (uintptr_t) (RPX_DATA + 0x1a9a52) == HARNESS_P2P_PORT);
+    CHECK(memory_is(OLV_DATA + OLV_URL_OFFSET, new_url, sizeof(new_url)));
+    end_title();
+}
+
+// an expanded heap with count used blocks, spaced out so none of them merge
+static MEMExpHeap *build_heap(uint32_t count) {
+    mock_clear(TEST_HEAP, TEST_HEAP_SIZE);
+    auto *heap = (MEMExpHeap *) (uintptr_t) TEST_HEAP;
+    heap->header.tag = MEM_EXPANDED_HEAP_TAG;
+    heap->header.flags = MEM_HEAP_FLAG_USE_LOCK;
+    heap->header.dataStart = (void *) (uintptr_t) (TEST_HEAP + 0x1000);
+    heap->header.dataEnd = (void *) (uintptr_t) (TEST_HEAP + TEST_HEAP_SIZE);
+    MEMInitList(&heap->header.list, offsetof(MEMHeapHeader, link));
+
+    MEMExpHeapBlock *prev = nullptr;
+    for (uint32_t i = 0; i < count; i++) {
+        auto *block = (MEMExpHeapBlock *) (uintptr_t) (TEST_HEAP + 0x1000 + i * 0x100);
+        block->blockSize = 0x40;
+        block->prev = prev;
+        if (prev) {
+            prev->next = block;
+        } else {
+            heap->usedList.head = block;
+        }
+        heap->usedList.tail = block;
+        prev = block;
+    }
+    return heap;
+}
+
+static void heap_walk() {
+    static mem_region regions[512];
+
+    mock_set_base_heap(MEM_BASE_HEAP_MEM2, &build_heap(100)->header);
+    CHECK(collect_heap_regions(regions, 0, 0x100000) == 100);
+    CHECK(regions[0].start == TEST_HEAP + 0x1000 + sizeof(MEMExpHeapBlock) && regions[0].size == 0x40);
+
+    // more blocks than fit - no partial answer that would hide where the rest of the heap is
+    mock_set_base_heap(MEM_BASE_HEAP_MEM2, &build_heap(600)->header);
+    CHECK(collect_heap_regions(regions, 0, 0x100000) == 0);
+    // the RPL sections still make it
+    mock_rpl_reset(nullptr, 0);
+    start_title(OTHER_TID, 16, {rpl("game.rpx", RPX_TEXT, RPX_DATA, RPX_DATA_SIZE)});
+    const auto count = collect_process_regions(regions);
+    CHECK(count >= 1 && count < std::size(regions));
+    end_title();
+
+    mock_set_base_heap(MEM_BASE_HEAP_MEM2, nullptr);
+    mock_clear(TEST_HEAP, TEST_HEAP_SIZE);
+}
+
+static void icon_cache() {
+    const char *dir = "fs:/vol/external01/wiiu/inkay/idbe";
+    static uint8_t icon[0x12080];
+
+    // the opt-in is decided when the Menu starts, not on every download
+    start_title(MENU_TID, 0, {});
+    auto download = hook<download_icon_fn>("DownloadIconFile__Q2_2nn4idbeFPvULUsb", FP_TARGET_PROCESS_WII_U_MENU);
+    CHECK(download != nullptr);
+    if (!download) return;
+    mkdir("fs:/vol/external01/wiiu/inkay", 0755);
+    mkdir(dir, 0755);
+    icon_downloads = 0;
+    CHECK(download(icon, MK8_TID, 81, false) && download(icon, MK8_TID, 81, false));
+    CHECK(icon_downloads == 2);
+    end_title();
+
+    start_title(MENU_TID, 0, {});
+    icon_downloads = 0;
+    CHECK(download(icon, MK8_TID, 81, false));
+    CHECK(icon_downloads == 1);
+    memset(icon, 0, sizeof(icon));
+    CHECK(download(icon, MK8_TID, 81, false));
+    CHECK(icon_downloads == 1 && icon[0] == 'I');
+    // 3DS icons always go to the server
+    CHECK(download(icon, MK8_TID, 81, true));
+    CHECK(icon_downloads == 2);
+    end_title();
+
+    // and it's still there for the next Menu process
+    start_title(MENU_TID, 0, {});
+    icon_downloads = 0;
+    CHECK(download(icon, MK8_TID, 81, false));
+    CHECK(icon_downloads == 0);
+    end_title();
+
+    // the rest of the session runs without the SD card opt-ins
+    CHECK(system("rm -rf fs:/vol/external01/wiiu/inkay") == 0);
+}
+
+static void patch_transaction() {
+    const uint32_t first = TEST_HEAP, second = TEST_HEAP + 0x10000;
+    const uint32_t value = 0x12345678;
+    const auto repl = std::span((const uint8_t *) &value, sizeof(value));
+    mock_clear(TEST_HEAP, TEST_HEAP_SIZE);
+
+    // the second target goes away between staging and commit, so neither is written
+    PatchTransaction unmapped;
+    CHECK(unmapped.stage(first, repl) && unmapped.stage(second, repl));
+    mock_unmap(second, 0x10000);
+    CHECK(!unmapped.commit());
+    CHECK(*(uint32_t *) (uintptr_t) first == 0);
+    mock_map(second, 0x10000);
+
+    PatchTransaction txn;
+    CHECK(txn.stage(first, repl) && txn.stage(second, repl));
+    CHECK(txn.commit());
+    CHECK(*(uint32_t *) (uintptr_t) first == value && *(uint32_t *) (uintptr_t) second == value);
+    patch_journal_rollback();
+    CHECK(*(uint32_t *) (uintptr_t) first == 0 && *(uint32_t *) (uintptr_t) second == 0);
+    mock_clear(TEST_HEAP, TEST_HEAP_SIZE);
+}
+
+#ifdef INKAY_TRACE
+static void trace_rotation() {
+    const char *trace = "fs:/vol/external01/wiiu/inkay_trace/trace.bin";
+    const char *old = "fs:/vol/external01/wiiu/inkay_trace/trace.old.bin";
+    struct stat st;
+
+    // the drain at the end of every process appends what the hooks traced
+    start_title(OTHER_TID, 16, {rpl("game.rpx", RPX_TEXT, RPX_DATA, RPX_DATA_SIZE)});
+    hook<gethostbyname_fn>("gethostbyname", FP_TARGET_PROCESS_GAME_AND_MENU)("nncs1.app.nintendowifi.net");
+    end_title();
+    CHECK(stat(trace, &st) == 0 && st.st_size > 4 && (st.st_size - 4) % 16 == 0);
+
+    // full, so the next drain starts a new one
+    CHECK(truncate(trace, 0x100000) == 0);
+    start_title(OTHER_TID, 16, {rpl("game.rpx", RPX_TEXT, RPX_DATA, RPX_DATA_SIZE)});
+    hook<gethostbyname_fn>("gethostbyname", FP_TARGET_PROCESS_GAME_AND_MENU)("nncs1.app.nintendowifi.net");
+    end_title();
+    CHECK(stat(old, &st) == 0 && st.st_size == 0x100000);
+    CHECK(stat(trace, &st) == 0 && st.st_size == 4 + 16);
+}
+#endif
+
+// per-call cost of each hook, over calling what it hooks directly
+
+static uint32_t overhead_calls = 1000000;
+
+template <typename F>
+static double time_calls(F &&fn) {
+    const auto start = std::chrono::steady_clock::now();
+    for (uint32_t i = 0; i < overhead_calls; i++) {
+        fn(i);
+    }
+    return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / overhead_calls;
+}
+
+static void report(const char *name, double hooked, double direct) {
+    printf("  %-34s %7.1f ns/call (%+.1f)\n", name, hooked, hooked - direct);
+}
+
+static void hook_overhead() {
+    start_title(MK8_TID, 81, {rpl("Turbo.rpx", RPX_TEXT, RPX_DATA, RPX_DATA_SIZE)});
+    auto ghbn = hook<gethostbyname_fn>("gethostbyname", FP_TARGET_PROCESS_GAME_AND_MENU);
+    auto gai = hook<getaddrinfo_fn>("getaddrinfo", FP_TARGET_PROCESS_GAME_AND_MENU);
+    auto session = hook<set_attribute_fn>("nex_MatchmakeSession_SetAttribute", FP_TARGET_PROCESS_GAME);
+    auto read = hook<fs_read_fn>("FSReadFile", FP_TARGET_PROCESS_MIIVERSE);
+    CHECK(ghbn && gai && session && read);
+    if (!ghbn || !gai || !session || !read) return;
+
+    // through a volatile pointer, so the direct call can't be inlined into nothing
+    gethostbyname_fn volatile direct_ghbn = &fake_gethostbyname;
+    getaddrinfo_fn volatile direct_gai = &fake_getaddrinfo;
+    set_attribute_fn volatile direct_session = &fake_SetAttribute;
+    fs_read_fn volatile direct_read = &fake_FSReadFile;
+    addrinfo *res;
+    FSClient client;
+    FSCmdBlock block;
+    uint8_t buffer[64];
+
+    printf("\n");
+    auto direct = time_calls([&](uint32_t) { direct_ghbn("nncs1.app.nintendowifi.net"); });
+    report("gethostbyname (replaced)", time_calls([&](uint32_t) { ghbn("nncs1.app.nintendowifi.net"); }), direct);
+    report("gethostbyname (not ours)", time_calls([&](uint32_t) { ghbn("example.com"); }), direct);
+    direct = time_calls([&](uint32_t) { direct_gai("example.com", "443", nullptr, &res); });
+    report("getaddrinfo (not ours)", time_calls([&](uint32_t) { gai("example.com", "443", nullptr, &res); }), direct);
+    direct = time_calls([&](uint32_t i) { direct_session(nullptr, i & 7, i); });
+    report("MatchmakeSession::SetAttribute", time_calls([&](uint32_t i) { session(nullptr, i & 7, i); }), direct);
+    direct = time_calls([&](uint32_t) { direct_read(&client, &block, buffer, 1, sizeof(buffer), 3, 0, 0); });
+    report("FSReadFile (Miiverse, not the CA)",
+           time_calls([&](uint32_t) { read(&client, &block, buffer, 1, sizeof(buffer), 3, 0, 0); }), direct);
+    end_title();
+}
+
+#ifdef HOOK_STATS
+// every scenario above went through the hooks - none of them may have touched the heap
+static void hook_allocations() {
+    // every hook, and every title start since the module came up, stayed off the heap
+    for (int id = 0; id < HOOK_ID_COUNT; id++) {
+        // reading and writing icons on the SD card is the icon cache's whole job, and opening a file allocates
+        if (id == HOOK_IDBE_DOWNLOADICONFILE) continue;
+        const auto allocs = hook_stats_allocations((hook_id) id);
+        if (allocs) fprintf(stderr, "hook %d made %u heap allocations\n", id, (unsigned) allocs);
+        CHECK(allocs == 0);
+    }
+    // which also shows the counter sees them
+    CHECK(hook_stats_allocations(HOOK_IDBE_DOWNLOADICONFILE) > 0);
+}
+#endif
+
+static int harness_main(int argc, char **argv) {
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--calls") == 0 && i + 1 < argc) {
+            overhead_calls = strtoul(argv[++i], nullptr, 0);
+        } else {
+            fprintf(stderr, "usage: %s [--calls n]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    // the module's fs:/ paths are relative, so give them a scratch directory to land in
+    char dir[] = "/tmp/inkay_harness_XXXXXX";
+    if (!mkdtemp(dir) || chdir(dir) != 0) {
+        perror("hook_harness: scratch directory");
+        return 1;
+    }
+    for (const char *path: {"fs:", "fs:/vol", "fs:/vol/content", "fs:/vol/external01", "fs:/vol/external01/wiiu"}) {
+        mkdir(path, 0755);
+    }
+
+    scenario("initialize", initialize);
+    scenario("title switches", title_switches);
+    scenario("RPL notifications", rpl_notifications);
+    scenario("Miiverse applet", miiverse_applet);
+    scenario("eShop and account settings CA", eshop_and_account_settings);
+    scenario("concurrent resolver calls", concurrent_resolver);
+    scenario("matchmaking and P2P", matchmaking_and_p2p);
+    scenario("network switch", network_switch);
+    scenario("heap walk", heap_walk);
+    scenario("icon cache", icon_cache);
+    scenario("patch transaction", patch_transaction);
+#ifdef INKAY_TRACE
+    scenario("trace rotation", trace_rotation);
+#endif
+    scenario("hook overhead", hook_overhead);
+#ifdef HOOK_STATS
+    scenario("hook allocations", hook_allocations);
+#endif
+
+    wums_deinitialize();
+    char remove[64];
+    snprintf(remove, sizeof(remove), "rm -rf %s", dir);
+    if (system(remove) != 0) fprintf(stderr, "hook_harness: couldn't remove %s\n", dir);
+
+    if (failures) {
+        fprintf(stderr, "%d check(s) failed\n", failures);
+        return 1;
+    }
+    return 0;
+}
+
+int main(int argc, char **argv) {
+    return mock_run(harness_main, argc, argv);
+}
@@ -0,0 +1,353 @@
+/*  Copyright 2026 Pretendo Network contributors <pretendo.network>
+
+    Permission to use, copy, modify, and/or distribute this software for any purpose with or without fee is hereby
+    granted, provided that the above copyright notice and this permission notice appear in all copies.
+
+    THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES WITH REGARD TO THIS SOFTWARE INCLUDING ALL
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT,
+    INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER
+    IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR
+    PERFORMANCE OF THIS SOFTWARE.
+*/
+
+#include "cafe.h"
+
+#include <coreinit/core.h>
+#include <coreinit/debug.h>
+#include <coreinit/interrupts.h>
+#include <coreinit/memdefaultheap.h>
+#include <coreinit/memexpheap.h>
+#include <coreinit/memlist.h>
+#include <coreinit/memory.h>
+#include <coreinit/memorymap.h>
+#include <coreinit/spinlock.h>
+#include <coreinit/time.h>
+#include <kernel/kernel.h>
+#include <whb/log.h>
+
+#include <atomic>
+#include <cstdarg>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <malloc.h>
+#include <mutex>
+#include <pthread.h>
+#include <sched.h>
+#include <sys/mman.h>
+
+#define MOCK_PAGE_SIZE 0x1000u
+#define MOCK_MAX_HOLES 32
+#define MOCK_MAIN_STACK_SIZE 0x800000
+
+struct mock_hole {
+    uint32_t start;
+    uint32_t end;
+};
+
+static mock_hole holes[MOCK_MAX_HOLES];
+static uint32_t hole_count = 0;
+static std::atomic<uint32_t> log_count = 0;
+static bool log_enabled = false;
+static MEMHeapHeader *base_heaps[MEM_BASE_HEAP_FG + 1];
+
+static void check_range(uint32_t start, uint32_t size) {
+    if (start < MOCK_WINDOW_START || (uint64_t) start + size > MOCK_WINDOW_END || (start | size) % MOCK_PAGE_SIZE) {
+        fprintf(stderr, "mock: %08x+%x isn't a page aligned range in the console window\n", start, size);
+        abort();
+    }
+}
+
+void *mock_low_stack(size_t size) {
+    void *stack = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_32BIT, -1, 0);
+    if (stack == MAP_FAILED) {
+        perror("mock: low stack");
+        abort();
+    }
+    return stack;
+}
+
+void mock_unmap(uint32_t start, uint32_t size) {
+    check_range(start, size);
+    if (hole_count == MOCK_MAX_HOLES) {
+        fprintf(stderr, "mock: too many unmapped ranges\n");
+        abort();
+    }
+    // really inaccessible, so a scan that reads an unmapped page crashes instead of passing
+    mmap((void *) (uintptr_t) start, size, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE | MAP_FIXED, -1, 0);
+    holes[hole_count++] = {start, start + size};
+}
+
+void mock_map(uint32_t start, uint32_t size) {
+    check_range(start, size);
+    mmap((void *) (uintptr_t) start, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE | MAP_FIXED,
+         -1, 0);
+
+    const uint32_t end = start + size;
+    for (uint32_t i = 0; i < hole_count;) {
+        auto &hole = holes[i];
+        if (hole.start >= start && hole.end <= end) {
+            hole = holes[--hole_count];
+        } else {
+            i++;
+        }
+    }
+}
+
+void mock_clear(uint32_t start, uint32_t size) {
+    check_range(start, size);
+    madvise((void *) (uintptr_t) start, size, MADV_DONTNEED);
+}
+
+void mock_set_base_heap(MEMBaseHeapType type, MEMHeapHeader *heap) {
+    base_heaps[type] = heap;
+}
+
+uint32_t mock_log_count() {
+    return log_count;
+}
+
+struct mock_main_args {
+    int (*fn)(int, char **);
+    int argc;
+    char **argv;
+    int ret;
+};
+
+static void *mock_main(void *arg) {
+    auto *args = (mock_main_args *) arg;
+    args->ret = args->fn(args->argc, args->argv);
+    return nullptr;
+}
+
+int mock_run(int (*fn)(int argc, char **argv), int argc, char **argv) {
+    // one brk arena for every thread - mmap'd chunks and per-thread arenas end up above 4 GiB
+    mallopt(M_MMAP_MAX, 0);
+    mallopt(M_ARENA_MAX, 1);
+    log_enabled = getenv("INKAY_HOST_LOG") != nullptr;
+
+    void *window = mmap((void *) (uintptr_t) MOCK_WINDOW_START, MOCK_WINDOW_END - MOCK_WINDOW_START,
+                        PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE | MAP_FIXED_NOREPLACE, -1, 0);
+    if (window != (void *) (uintptr_t) MOCK_WINDOW_START) {
+        fprintf(stderr, "mock: couldn't reserve the console address window\n");
+        return 1;
+    }
+
+    mock_main_args args = {fn, argc, argv, 1};
+    pthread_attr_t attr;
+    pthread_attr_init(&attr);
+    pthread_attr_setstack(&attr, mock_low_stack(MOCK_MAIN_STACK_SIZE), MOCK_MAIN_STACK_SIZE);
+
+    pthread_t thread;
+    if (pthread_create(&thread, &attr, mock_main, &args) != 0) {
+        fprintf(stderr, "mock: couldn't start the main thread\n");
+        return 1;
+    }
+    pthread_join(thread, nullptr);
+    pthread_attr_destroy(&attr);
+    return args.ret;
+}
+
+uint32_t OSGetCoreId() {
+    const int cpu = sched_getcpu();
+    return cpu < 0 ? 0 : (uint32_t) cpu % 3;
+}
+
+uint32_t OSGetCoreCount() {
+    return 3;
+}
+
+uint32_t OSEffectiveToPhysical(uint32_t virtualAddress) {
+    if (!virtualAddress) return 0;
+    for (uint32_t i = 0; i < hole_count; i++) {
+        if (virtualAddress >= holes[i].start && virtualAddress < holes[i].end) return 0;
+    }
+    return virtualAddress;
+}
+
+uint32_t OSPhysicalToEffectiveCached(uint32_t physicalAddress) {
+    return physicalAddress;
+}
+
+void KernelCopyData(uint32_t dst, uint32_t src, uint32_t size) {
+    if (!dst || !src) {
+        fprintf(stderr, "mock: KernelCopyData(%08x, %08x, %u) with an untranslated address\n", dst, src, size);
+        abort();
+    }
+    memmove((void *) (uintptr_t) dst, (const void *) (uintptr_t) src, size);
+}
+
+static uint64_t host_ticks() {
+    timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ((uint64_t) ts.tv_sec * 1000000000ull + ts.tv_nsec) * OSTimerClockSpeed / 1000000000ull;
+}
+
+OSTime OSGetTime() {
+    return (OSTime) host_ticks();
+}
+
+OSTime OSGetSystemTime() {
+    return (OSTime) host_ticks();
+}
+
+OSTick OSGetTick() {
+    return (OSTick) host_ticks();
+}
+
+OSTick OSGetSystemTick() {
+    return (OSTick) host_ticks();
+}
+
+static bool log_line(const char *fmt, va_list args) {
+    log_count++;
+    if (!log_enabled) return true;
+
+    vfprintf(stderr, fmt, args);
+    fputc('\n', stderr);
+    return true;
+}
+
+void OSFatal(const char *msg) {
+    fprintf(stderr, "mock: OSFatal: %s\n", msg);
+    abort();
+}
+
+void OSReport(const char *fmt, ...) {
+    va_list args;
+    va_start(args, fmt);
+    log_line(fmt, args);
+    va_end(args);
+}
+
+bool WHBLogPrint(const char *str) {
+    return WHBLogPrintf("%s", str);
+}
+
+bool WHBLogPrintf(const char *fmt, ...) {
+    va_list args;
+    va_start(args, fmt);
+    log_line(fmt, args);
+    va_end(args);
+    return true;
+}
+
+bool WHBLogWrite(const char *str) {
+    return WHBLogWritef("%s", str);
+}
+
+bool WHBLogWritef(const char *fmt, ...) {
+    va_list args;
+    va_start(args, fmt);
+    log_line(fmt, args);
+    va_end(args);
+    return true;
+}
+
+int OSGetMemBound(OSMemoryType type, uint32_t *addr, uint32_t *size) {
+    if (type != OS_MEM2) return -1;
+    *addr = 0x10000000;
+    *size = 0x10000000;
+    return 0;
+}
+
+MEMHeapHandle MEMGetBaseHeapHandle(MEMBaseHeapType type) {
+    return (uint32_t) type < std::size(base_heaps) ? base_heaps[type] : nullptr;
+}
+
+static void *default_alloc(uint32_t size) {
+    return malloc(size);
+}
+
+static void *default_alloc_ex(uint32_t size, int32_t alignment) {
+    // negative alignments allocate from the top of the heap, which makes no difference here
+    return memalign(alignment < 0 ? -alignment : alignment, size);
+}
+
+MEMAllocFromDefaultHeapFn MEMAllocFromDefaultHeap = default_alloc;
+MEMAllocFromDefaultHeapExFn MEMAllocFromDefaultHeapEx = default_alloc_ex;
+MEMFreeToDefaultHeapFn MEMFreeToDefaultHeap = free;
+
+uint32_t MEMGetTotalFreeSizeForExpHeap(MEMHeapHandle heap) {
+    uint32_t free = 0;
+    for (auto *block = ((MEMExpHeap *) heap)->freeList.head; block; block = block->next) {
+        free += block->blockSize;
+    }
+    return free;
+}
+
+static MEMMemoryLink *list_link(MEMMemoryList *list, void *object) {
+    return (MEMMemoryLink *) ((uint8_t *) object + list->offsetToMemoryLink);
+}
+
+void MEMInitList(MEMMemoryList *list, uint16_t offsetToMemoryLink) {
+    *list = {nullptr, nullptr, 0, offsetToMemoryLink};
+}
+
+void MEMAppendListObject(MEMMemoryList *list, void *object) {
+    *list_link(list, object) = {list->tail, nullptr};
+    if (list->tail) {
+        list_link(list, list->tail)->next = object;
+    } else {
+        list->head = object;
+    }
+    list->tail = object;
+    list->count++;
+}
+
+void *MEMGetNextListObject(MEMMemoryList *list, void *object) {
+    return object ? list_link(list, object)->next : list->head;
+}
+
+static std::mutex interrupts_off;
+static thread_local bool interrupts_enabled = true;
+
+bool OSDisableInterrupts() {
+    const bool was_enabled = interrupts_enabled;
+    if (was_enabled) {
+        interrupts_off.lock();
+        interrupts_enabled = false;
+    }
+    return was_enabled;
+}
+
+bool OSRestoreInterrupts(bool enable) {
+    const bool was_enabled = interrupts_enabled;
+    if (enable && !was_enabled) {
+        interrupts_enabled = true;
+        interrupts_off.unlock();
+    }
+    return was_enabled;
+}
+
+static uint32_t spinlock_owner_id() {
+    static std::atomic<uint32_t> next_id = 1;
+    static thread_local uint32_t id = next_id++;
+    return id;
+}
+
+// recursive, like the real one
+bool OSUninterruptibleSpinLock_Acquire(OSSpinLock *spinlock) {
+    const auto self = spinlock_owner_id();
+    if (spinlock->owner.load() == self) {
+        spinlock->recursion++;
+        return true;
+    }
+
+    uint32_t expected = 0;
+    while (!spinlock->owner.compare_exchange_weak(expected, self)) {
+        expected = 0;
+        sched_yield();
+    }
+    return true;
+}
+
+bool OSUninterruptibleSpinLock_Release(OSSpinLock *spinlock) {
+    if (spinlock->recursion) {
+        spinlock->recursion--;
+        return true;
+    }
+    spinlock->owner = 0;
+    return true;
+}
@@ -0,0 +1,96 @@
+/*  Copyright 2026 Pretendo Network contributors <pretendo.network>
+
+    Permission to use, copy, modify, and/or distribute this software for any purpose with or without fee is hereby
+    granted, provided that the above copyright notice and this permission notice appear in all copies.
+
+    THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES WITH REGARD TO THIS SOFTWARE INCLUDING ALL
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT,
+    INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER
+    IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR
+    PERFORMANCE OF THIS SOFTWARE.
+*/
+
+#pragma once
+
+#include <coreinit/dynload.h>
+#include <coreinit/memheap.h>
+#include <coreinit/mcp.h>
+#include <function_patcher/function_patching.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+
+/**
+ * Control side of the host mocks. Inkay casts pointers to uint32_t all over the place, so a host build only works if
+ * everything it can point at lives below 4 GiB: the binary is linked low (see the Makefile), malloc is kept on the
+ * brk heap, and mock_run() moves the program onto a low stack. Console addresses in [MOCK_WINDOW_START,
+ * MOCK_WINDOW_END) are reserved up front, so code and data can be placed where a title would have them.
+ */
+#define MOCK_WINDOW_START 0x01000000u
+#define MOCK_WINDOW_END   0x50000000u
+
+// sets up the address space and runs fn on a low stack, returns what fn did
+int mock_run(int (*fn)(int argc, char **argv), int argc, char **argv);
+
+// a stack below 4 GiB for threads the mocks start, never freed
+void *mock_low_stack(size_t size);
+
+// makes [start, start + size) inaccessible and untranslatable, like a page the title never mapped. Page aligned.
+void mock_unmap(uint32_t start, uint32_t size);
+// maps it back in, zero filled
+void mock_map(uint32_t start, uint32_t size);
+// zero fills and hands the pages back to the host
+void mock_clear(uint32_t start, uint32_t size);
+
+// threads started through OSResumeThread that haven't returned yet
+uint32_t mock_threads_alive();
+
+// FS clients added and not yet deleted
+uint32_t mock_fs_clients();
+
+// number of WHBLog* calls so far, whether or not they were printed
+uint32_t mock_log_count();
+
+// the module's WUMS hooks, see mock/include/wums.h
+void wums_initialize();
+void wums_deinitialize();
+void wums_application_starts();
+void wums_all_application_starts_done();
+void wums_application_ends();
+// a WUMS_EXPORT_FUNCTION by name, nullptr if the module doesn't export it
+void *mock_wums_export(const char *name);
+
+// what OSGetTitleID and MCP_GetTitleInfo answer - no version makes MCP_GetTitleInfo fail
+void mock_set_title(uint64_t title_id, std::optional<uint16_t> version);
+// what MCP and UserConfig say about the console
+void mock_set_console(const char *serial, MCPSystemVersion os_version, uint32_t language);
+// number of MCP calls so far
+uint32_t mock_mcp_calls();
+
+// a new process with these RPLs already loaded - nobody is notified, like a title that just started
+void mock_rpl_reset(const OSDynLoad_NotifyData *rpls, size_t count);
+// loads or unloads an RPL, telling everyone with a notify callback
+void mock_rpl_load(const OSDynLoad_NotifyData &rpl);
+void mock_rpl_unload(const char *name);
+
+// what MEMGetBaseHeapHandle hands out, nothing to start with
+void mock_set_base_heap(MEMBaseHeapType type, MEMHeapHeader *heap);
+
+// IOSU memory as Mocha sees it, 0 where nothing was ever written
+uint32_t mock_iosu_read(uint32_t address);
+uint32_t mock_iosu_writes();
+// the next read or write of this address fails
+void mock_iosu_fail_access(uint32_t address);
+
+// every notification the module has shown, oldest first
+uint32_t mock_notification_count();
+const char *mock_notification(uint32_t index);
+
+// what a hook's real_ pointer gets set to, by FunctionPatcher function name (or the hook's name, for executable
+// patches). Register before the hooks are installed.
+void mock_fp_original(const char *function_name, void *original);
+// the installed hook for this function and process, nullptr if there isn't one
+void *mock_fp_hook(const char *function_name, FunctionPatcherTargetProcess process);
+// hooks installed right now
+uint32_t mock_fp_installed();
@@ -0,0 +1,93 @@
+/*  Copyright 2026 Pretendo Network contributors <pretendo.network>
+
+    Permission to use, copy, modify, and/or distribute this software for any purpose with or without fee is hereby
+    granted, provided that the above copyright notice and this permission notice appear in all copies.
+
+    THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES WITH REGARD TO THIS SOFTWARE INCLUDING ALL
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT,
+    INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER
+    IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR
+    PERFORMANCE OF THIS SOFTWARE.
+*/
+
+#include "cafe.h"
+
+#include <coreinit/filesystem.h>
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+
+// nothing in here may allocate - the harness counts what the module's title start puts on the heap, and these run
+// inside it
+
+static std::atomic<uint32_t> clients = 0;
+
+// /vol/external01/... -> fs:/vol/external01/..., relative to the harness's scratch directory
+static bool host_path(char (&out)[256], const char *path) {
+    return snprintf(out, sizeof(out), "fs:%s", path) < (int) sizeof(out);
+}
+
+uint32_t mock_fs_clients() {
+    return clients;
+}
+
+void FSInit() {
+}
+
+FSStatus FSAddClient(FSClient *client, FSErrorFlag errorMask) {
+    clients++;
+    return FS_STATUS_OK;
+}
+
+FSStatus FSDelClient(FSClient *client, FSErrorFlag errorMask) {
+    clients--;
+    return FS_STATUS_OK;
+}
+
+void FSInitCmdBlock(FSCmdBlock *block) {
+}
+
+FSStatus FSGetStat(FSClient *client, FSCmdBlock *block, const char *path, FSStat *stat, FSErrorFlag errorMask) {
+    char host[256];
+    struct stat st;
+    if (!host_path(host, path) || ::stat(host, &st) != 0) return FS_STATUS_NOT_FOUND;
+
+    *stat = {};
+    stat->flags = S_ISDIR(st.st_mode) ? FS_STAT_DIRECTORY : (FSStatFlags) 0;
+    stat->size = (uint32_t) st.st_size;
+    return FS_STATUS_OK;
+}
+
+FSStatus FSOpenFile(FSClient *client, FSCmdBlock *block, const char *path, const char *mode, FSFileHandle *handle,
+                    FSErrorFlag errorMask) {
+    char host[256];
+    if (mode[0] != 'r' || !host_path(host, path)) return FS_STATUS_UNSUPPORTED_CMD;
+
+    const int fd = open(host, O_RDONLY);
+    if (fd < 0) return FS_STATUS_NOT_FOUND;
+    *handle = (FSFileHandle) fd;
+    return FS_STATUS_OK;
+}
+
+FSStatus FSReadFile(FSClient *client, FSCmdBlock *block, uint8_t *buffer, uint32_t size, uint32_t count,
+                    FSFileHandle handle, uint32_t unk1, FSErrorFlag errorMask) {
+    // the console won't DMA into anything less aligned
+    if ((uintptr_t) buffer % 0x40) {
+        fprintf(stderr, "FSReadFile: buffer %p isn't 64-byte aligned\n", buffer);
+        return FS_STATUS_FATAL_ERROR;
+    }
+
+    const ssize_t read = ::read((int) handle, buffer, (size_t) size * count);
+    if (read < 0) return FS_STATUS_MEDIA_ERROR;
+    return (FSStatus) (read / size);
+}
+
+FSStatus FSCloseFile(FSClient *client, FSCmdBlock *block, FSFileHandle handle, FSErrorFlag errorMask) {
+    close((int) handle);
+    return FS_STATUS_OK;
+}
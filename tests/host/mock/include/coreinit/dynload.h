@@ -0,0 +1,52 @@
+/*  Copyright 2026 Pretendo Network contributors <pretendo.network>
+
+    Permission to use, copy, modify, and/or distribute this software for any purpose with or without fee is hereby
+    granted, provided that the above copyright notice and this permission notice appear in all copies.
+
+    THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES WITH REGARD TO THIS SOFTWARE INCLUDING ALL
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT,
+    INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER
+    IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR
+    PERFORMANCE OF THIS SOFTWARE.
+*/
+
+#pragma once
+
+#include <cstdint>
+
+typedef void *OSDynLoad_Module;
+
+typedef enum OSDynLoad_Error {
+    OS_DYNLOAD_OK = 0,
+    OS_DYNLOAD_INVALID_NOTIFY_PTR = 0xBAD10030,
+} OSDynLoad_Error;
+
+typedef enum OSDynLoad_NotifyReason {
+    OS_DYNLOAD_NOTIFY_UNLOADED = 0,
+    OS_DYNLOAD_NOTIFY_LOADED = 1,
+} OSDynLoad_NotifyReason;
+
+typedef struct OSDynLoad_NotifyData {
+    char *name;
+
+    uint32_t textAddr;
+    uint32_t textOffset;
+    uint32_t textSize;
+
+    uint32_t dataAddr;
+    uint32_t dataOffset;
+    uint32_t dataSize;
+
+    uint32_t readAddr;
+    uint32_t readOffset;
+    uint32_t readSize;
+} OSDynLoad_NotifyData;
+
+typedef void (*OSDynLoadNotifyFunc)(OSDynLoad_Module module, void *userContext, OSDynLoad_NotifyReason notifyReason,
+                                    OSDynLoad_NotifyData *infos);
+
+// the loaded RPLs come from mock_rpl_load()/mock_rpl_unload(), which also run the notify callbacks
+int32_t OSDynLoad_GetNumberOfRPLs();
+bool OSDynLoad_GetRPLInfo(uint32_t first, uint32_t count, OSDynLoad_NotifyData *outInfos);
+OSDynLoad_Error OSDynLoad_AddNotifyCallback(OSDynLoadNotifyFunc notifyFn, void *userContext);
+void OSDynLoad_DelNotifyCallback(OSDynLoadNotifyFunc notifyFn, void *userContext);
@@ -0,0 +1,78 @@
+/*  Copyright 2026 Pretendo Network contributors <pretendo.network>
+
+    Permission to use, copy, modify, and/or distribute this software for any purpose with or without fee is hereby
+    granted, provided that the above copyright notice and this permission notice appear in all copies.
+
+    THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES WITH REGARD TO THIS SOFTWARE INCLUDING ALL
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT,
+    INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER
+    IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR
+    PERFORMANCE OF THIS SOFTWARE.
+*/
+
+#pragma once
+
+#include <cstdint>
+
+typedef struct FSClient {
+    uint8_t buffer[0x1700];
+} FSClient;
+
+typedef struct FSCmdBlock {
+    uint8_t buffer[0xA80];
+} FSCmdBlock;
+
+typedef uint32_t FSFileHandle;
+
+typedef enum FSStatus {
+    FS_STATUS_OK = 0,
+    FS_STATUS_CANCELLED = -1,
+    FS_STATUS_END = -2,
+    FS_STATUS_MAX = -3,
+    FS_STATUS_ALREADY_OPEN = -4,
+    FS_STATUS_EXISTS = -5,
+    FS_STATUS_NOT_FOUND = -6,
+    FS_STATUS_NOT_FILE = -7,
+    FS_STATUS_NOT_DIR = -8,
+    FS_STATUS_ACCESS_ERROR = -9,
+    FS_STATUS_PERMISSION_ERROR = -10,
+    FS_STATUS_FILE_TOO_BIG = -11,
+    FS_STATUS_STORAGE_FULL = -12,
+    FS_STATUS_JOURNAL_FULL = -13,
+    FS_STATUS_UNSUPPORTED_CMD = -14,
+    FS_STATUS_MEDIA_NOT_READY = -15,
+    FS_STATUS_MEDIA_ERROR = -17,
+    FS_STATUS_CORRUPTED = -18,
+    FS_STATUS_FATAL_ERROR = -0x400,
+} FSStatus;
+
+typedef enum FSErrorFlag {
+    FS_ERROR_FLAG_NONE = 0x0,
+    FS_ERROR_FLAG_ALL = 0xFFFFFFFF,
+} FSErrorFlag;
+
+typedef enum FSStatFlags {
+    FS_STAT_DIRECTORY = 0x80000000,
+} FSStatFlags;
+
+typedef struct FSStat {
+    FSStatFlags flags;
+    uint32_t mode;
+    uint32_t owner;
+    uint32_t group;
+    uint32_t size;
+    uint8_t unk[0x50];
+} FSStat;
+
+// see mock/fs.cpp - /vol/... paths are the fs:/vol/... ones under the current directory. The FS hooks never get here,
+// they're driven through FunctionPatcher's real_ pointers instead
+void FSInit();
+FSStatus FSAddClient(FSClient *client, FSErrorFlag errorMask);
+FSStatus FSDelClient(FSClient *client, FSErrorFlag errorMask);
+void FSInitCmdBlock(FSCmdBlock *block);
+FSStatus FSGetStat(FSClient *client, FSCmdBlock *block, const char *path, FSStat *stat, FSErrorFlag errorMask);
+FSStatus FSOpenFile(FSClient *client, FSCmdBlock *block, const char *path, const char *mode, FSFileHandle *handle,
+                    FSErrorFlag errorMask);
+FSStatus FSReadFile(FSClient *client, FSCmdBlock *block, uint8_t *buffer, uint32_t size, uint32_t count,
+                    FSFileHandle handle, uint32_t unk1, FSErrorFlag errorMask);
+FSStatus FSCloseFile(FSClient *client, FSCmdBlock *block, FSFileHandle handle, FSErrorFlag errorMask);
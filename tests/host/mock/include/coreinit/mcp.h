@@ -0,0 +1,66 @@
+/*  Copyright 2026 Pretendo Network contributors <pretendo.network>
+
+    Permission to use, copy, modify, and/or distribute this software for any purpose with or without fee is hereby
+    granted, provided that the above copyright notice and this permission notice appear in all copies.
+
+    THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES WITH REGARD TO THIS SOFTWARE INCLUDING ALL
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT,
+    INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER
+    IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR
+    PERFORMANCE OF THIS SOFTWARE.
+*/
+
+#pragma once
+
+#include <cstdint>
+
+typedef enum MCPRegion {
+    MCP_REGION_JAPAN = 0x01,
+    MCP_REGION_USA = 0x02,
+    MCP_REGION_EUROPE = 0x04,
+    MCP_REGION_CHINA = 0x10,
+    MCP_REGION_KOREA = 0x20,
+    MCP_REGION_TAIWAN = 0x40,
+} MCPRegion;
+
+typedef struct __attribute__((__packed__)) MCPTitleListType {
+    uint64_t titleId;
+    uint32_t groupId;
+    char path[56];
+    uint32_t appType;
+    uint16_t titleVersion;
+    uint64_t osVersion;
+    uint32_t sdkVersion;
+    char indexedDevice[10];
+    uint8_t unk0x60;
+} MCPTitleListType;
+
+typedef struct MCPSysProdSettings {
+    MCPRegion product_area;
+    uint16_t eeprom_version;
+    uint8_t unk1[0x2];
+    MCPRegion game_region;
+    uint8_t unk2[0x4];
+    char ntsc_pal[0x5];
+    char five_ghz_country_code[0x3];
+    char five_ghz_country_code_revision;
+    char code_id[0x8];
+    char serial_id[0xC];
+    uint8_t unk3[0x4];
+    char model_number[0x10];
+    uint32_t version;
+} MCPSysProdSettings;
+
+typedef struct MCPSystemVersion {
+    int32_t major;
+    int32_t minor;
+    int32_t patch;
+    char region;
+} MCPSystemVersion;
+
+// answers come from mock_set_title()/mock_set_console(), every call is counted by mock_mcp_calls()
+int32_t MCP_Open();
+int32_t MCP_Close(int32_t handle);
+int32_t MCP_GetTitleInfo(int32_t handle, uint64_t titleId, MCPTitleListType *titleInfo);
+int32_t MCP_GetSysProdSettings(int32_t handle, MCPSysProdSettings *settings);
+int32_t MCP_GetSystemVersion(int32_t handle, MCPSystemVersion *version);
@@ -0,0 +1,38 @@
+/*  Copyright 2026 Pretendo Network contributors <pretendo.network>
+
+    Permission to use, copy, modify, and/or distribute this software for any purpose with or without fee is hereby
+    granted, provided that the above copyright notice and this permission notice appear in all copies.
+
+    THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES WITH REGARD TO THIS SOFTWARE INCLUDING ALL
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT,
+    INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER
+    IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR
+    PERFORMANCE OF THIS SOFTWARE.
+*/
+
+#pragma once
+
+#include "memheap.h"
+
+typedef struct MEMExpHeapBlock {
+    uint32_t attribs;
+    uint32_t blockSize;
+    struct MEMExpHeapBlock *prev;
+    struct MEMExpHeapBlock *next;
+    uint16_t tag;
+} MEMExpHeapBlock;
+
+typedef struct MEMExpHeapBlockList {
+    MEMExpHeapBlock *head;
+    MEMExpHeapBlock *tail;
+} MEMExpHeapBlockList;
+
+typedef struct MEMExpHeap {
+    MEMHeapHeader header;
+    MEMExpHeapBlockList freeList;
+    MEMExpHeapBlockList usedList;
+    uint16_t groupId;
+    uint16_t attribs;
+} MEMExpHeap;
+
+uint32_t MEMGetTotalFreeSizeForExpHeap(MEMHeapHandle heap);
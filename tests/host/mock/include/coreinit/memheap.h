@@ -0,0 +1,53 @@
+/*  Copyright 2026 Pretendo Network contributors <pretendo.network>
+
+    Permission to use, copy, modify, and/or distribute this software for any purpose with or without fee is hereby
+    granted, provided that the above copyright notice and this permission notice appear in all copies.
+
+    THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES WITH REGARD TO THIS SOFTWARE INCLUDING ALL
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT,
+    INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER
+    IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR
+    PERFORMANCE OF THIS SOFTWARE.
+*/
+
+#pragma once
+
+#include "memlist.h"
+#include "spinlock.h"
+
+#include <cstdint>
+
+typedef enum MEMBaseHeapType {
+    MEM_BASE_HEAP_MEM1 = 0,
+    MEM_BASE_HEAP_MEM2 = 1,
+    MEM_BASE_HEAP_FG = 8,
+} MEMBaseHeapType;
+
+typedef enum MEMHeapTag {
+    MEM_BLOCK_HEAP_TAG = 0x424C4B48u,
+    MEM_EXPANDED_HEAP_TAG = 0x45585048u,
+    MEM_FRAME_HEAP_TAG = 0x46524D48u,
+    MEM_UNIT_HEAP_TAG = 0x554E5448u,
+    MEM_USER_HEAP_TAG = 0x55535248u,
+} MEMHeapTag;
+
+typedef enum MEMHeapFlags {
+    MEM_HEAP_FLAG_ZERO_ALLOCATED = 1 << 0,
+    MEM_HEAP_FLAG_DEBUG_MODE = 1 << 1,
+    MEM_HEAP_FLAG_USE_LOCK = 1 << 2,
+} MEMHeapFlags;
+
+typedef struct MEMHeapHeader {
+    MEMHeapTag tag;
+    MEMMemoryLink link;
+    MEMMemoryList list;
+    void *dataStart;
+    void *dataEnd;
+    OSSpinLock lock;
+    uint32_t flags;
+} MEMHeapHeader;
+
+typedef MEMHeapHeader *MEMHeapHandle;
+
+// whatever mock_set_base_heap() put there, nothing by default
+MEMHeapHandle MEMGetBaseHeapHandle(MEMBaseHeapType type);
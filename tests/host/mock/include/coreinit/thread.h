@@ -0,0 +1,53 @@
+/*  Copyright 2026 Pretendo Network contributors <pretendo.network>
+
+    Permission to use, copy, modify, and/or distribute this software for any purpose with or without fee is hereby
+    granted, provided that the above copyright notice and this permission notice appear in all copies.
+
+    THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES WITH REGARD TO THIS SOFTWARE INCLUDING ALL
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT,
+    INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER
+    IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR
+    PERFORMANCE OF THIS SOFTWARE.
+*/
+
+#pragma once
+
+#include "time.h"
+
+#include <cstdint>
+#include <pthread.h>
+
+typedef int (*OSThreadEntryPointFn)(int argc, const char **argv);
+
+typedef enum OSThreadAttributes {
+    OS_THREAD_ATTRIB_AFFINITY_CPU0 = 1 << 0,
+    OS_THREAD_ATTRIB_AFFINITY_CPU1 = 1 << 1,
+    OS_THREAD_ATTRIB_AFFINITY_CPU2 = 1 << 2,
+    OS_THREAD_ATTRIB_AFFINITY_ANY = ((1 << 0) | (1 << 1) | (1 << 2)),
+    OS_THREAD_ATTRIB_DETACHED = 1 << 3,
+    OS_THREAD_ATTRIB_STACK_USAGE = 1 << 5,
+} OSThreadAttributes;
+
+// a pthread under the hood - it gets its own low stack rather than the one it was given, which is usually too small
+// for glibc
+typedef struct OSThread {
+    pthread_t thread;
+    OSThreadEntryPointFn entry;
+    int argc;
+    const char **argv;
+    int result;
+    bool detached;
+    bool resumed;
+    const char *name;
+} OSThread;
+
+bool OSCreateThread(OSThread *thread, OSThreadEntryPointFn entry, int32_t argc, char *argv, void *stack,
+                    uint32_t stackSize, int32_t priority, OSThreadAttributes attributes);
+void OSSetThreadName(OSThread *thread, const char *name);
+// the OSThread the caller was started from, or a stand-in for threads the mocks didn't start (like main)
+OSThread *OSGetCurrentThread();
+int32_t OSResumeThread(OSThread *thread);
+bool OSJoinThread(OSThread *thread, int *threadResult);
+void OSDetachThread(OSThread *thread);
+void OSSleepTicks(OSTime ticks);
+void OSYieldThread();
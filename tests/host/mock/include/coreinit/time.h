@@ -0,0 +1,34 @@
+/*  Copyright 2026 Pretendo Network contributors <pretendo.network>
+
+    Permission to use, copy, modify, and/or distribute this software for any purpose with or without fee is hereby
+    granted, provided that the above copyright notice and this permission notice appear in all copies.
+
+    THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES WITH REGARD TO THIS SOFTWARE INCLUDING ALL
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT,
+    INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER
+    IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR
+    PERFORMANCE OF THIS SOFTWARE.
+*/
+
+#pragma once
+
+#include <cstdint>
+
+typedef int32_t OSTick;
+typedef int64_t OSTime;
+
+// the console's timer runs at a quarter of the 248.625 MHz bus clock - keep it so tick maths overflows the same way
+#define OSTimerClockSpeed 62156250ull
+
+#define OSSecondsToTicks(val)      ((uint64_t) (val) * (uint64_t) OSTimerClockSpeed)
+#define OSMillisecondsToTicks(val) (((uint64_t) (val) * (uint64_t) OSTimerClockSpeed) / 1000ull)
+#define OSMicrosecondsToTicks(val) (((uint64_t) (val) * (uint64_t) OSTimerClockSpeed) / 1000000ull)
+
+#define OSTicksToSeconds(val)      ((uint64_t) (val) / (uint64_t) OSTimerClockSpeed)
+#define OSTicksToMilliseconds(val) (((uint64_t) (val) * 1000ull) / (uint64_t) OSTimerClockSpeed)
+#define OSTicksToMicroseconds(val) (((uint64_t) (val) * 1000000ull) / (uint64_t) OSTimerClockSpeed)
+
+OSTime OSGetTime();
+OSTime OSGetSystemTime();
+OSTick OSGetTick();
+OSTick OSGetSystemTick();
@@ -0,0 +1,49 @@
+/*  Copyright 2026 Pretendo Network contributors <pretendo.network>
+
+    Permission to use, copy, modify, and/or distribute this software for any purpose with or without fee is hereby
+    granted, provided that the above copyright notice and this permission notice appear in all copies.
+
+    THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES WITH REGARD TO THIS SOFTWARE INCLUDING ALL
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT,
+    INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER
+    IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR
+    PERFORMANCE OF THIS SOFTWARE.
+*/
+
+#pragma once
+
+#include <cstdint>
+
+typedef int32_t UCHandle;
+
+typedef enum UCDataType {
+    UC_DATATYPE_UNDEFINED = 0x00,
+    UC_DATATYPE_UNSIGNED_BYTE = 0x01,
+    UC_DATATYPE_UNSIGNED_SHORT = 0x02,
+    UC_DATATYPE_UNSIGNED_INT = 0x03,
+    UC_DATATYPE_SIGNED_INT = 0x04,
+    UC_DATATYPE_FLOAT = 0x05,
+    UC_DATATYPE_STRING = 0x06,
+    UC_DATATYPE_HEXBINARY = 0x07,
+    UC_DATATYPE_COMPLEX = 0x08,
+    UC_DATATYPE_INVALID = 0xFF,
+} UCDataType;
+
+typedef enum UCError {
+    UC_ERROR_OK = 0,
+    UC_ERROR_ERROR = -1,
+} UCError;
+
+typedef struct UCSysConfig {
+    char name[64];
+    uint32_t access;
+    UCDataType dataType;
+    UCError error;
+    uint32_t dataSize;
+    void *data;
+} UCSysConfig;
+
+// only cafe.language is known, from mock_set_console()
+UCHandle UCOpen();
+void UCClose(UCHandle handle);
+UCError UCReadSysConfig(UCHandle handle, uint32_t count, UCSysConfig *settings);
@@ -0,0 +1,177 @@
+/*  Copyright 2026 Pretendo Network contributors <pretendo.network>
+
+    Permission to use, copy, modify, and/or distribute this software for any purpose with or without fee is hereby
+    granted, provided that the above copyright notice and this permission notice appear in all copies.
+
+    THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES WITH REGARD TO THIS SOFTWARE INCLUDING ALL
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT,
+    INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER
+    IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR
+    PERFORMANCE OF THIS SOFTWARE.
+*/
+
+#pragma once
+
+#include <cstdint>
+
+typedef uint32_t PatchedFunctionHandle;
+
+typedef enum FunctionPatcherStatus {
+    FUNCTION_PATCHER_RESULT_SUCCESS = 0,
+    FUNCTION_PATCHER_RESULT_MODULE_NOT_FOUND = -1,
+    FUNCTION_PATCHER_RESULT_UNSUPPORTED_STRUCT_VERSION = -3,
+    FUNCTION_PATCHER_RESULT_INVALID_ARGUMENT = -4,
+    FUNCTION_PATCHER_RESULT_PATCH_NOT_FOUND = -5,
+    FUNCTION_PATCHER_RESULT_LIB_UNINITIALIZED = -0x20,
+    FUNCTION_PATCHER_RESULT_UNKNOWN_ERROR = -0x100,
+} FunctionPatcherStatus;
+
+typedef enum function_replacement_library_type_t {
+    LIBRARY_AVM,
+    LIBRARY_CAMERA,
+    LIBRARY_COREINIT,
+    LIBRARY_DC,
+    LIBRARY_DMAE,
+    LIBRARY_DRMAPP,
+    LIBRARY_ERREULA,
+    LIBRARY_GX2,
+    LIBRARY_H264,
+    LIBRARY_LZMA920,
+    LIBRARY_MIC,
+    LIBRARY_NFC,
+    LIBRARY_NIO_PROF,
+    LIBRARY_NLIBCURL,
+    LIBRARY_NLIBNSS,
+    LIBRARY_NLIBNSS2,
+    LIBRARY_NN_AC,
+    LIBRARY_NN_ACP,
+    LIBRARY_NN_ACT,
+    LIBRARY_NN_AOC,
+    LIBRARY_NN_BOSS,
+    LIBRARY_NN_CCR,
+    LIBRARY_NN_CMPT,
+    LIBRARY_NN_DLP,
+    LIBRARY_NN_EC,
+    LIBRARY_NN_FP,
+    LIBRARY_NN_HAI,
+    LIBRARY_NN_HPAD,
+    LIBRARY_NN_IDBE,
+    LIBRARY_NN_NDM,
+    LIBRARY_NN_NETS2,
+    LIBRARY_NN_NFP,
+    LIBRARY_NN_NIM,
+    LIBRARY_NN_OLV,
+    LIBRARY_NN_PDM,
+    LIBRARY_NN_SAVE,
+    LIBRARY_NN_SL,
+    LIBRARY_NN_SPM,
+    LIBRARY_NN_TEMP,
+    LIBRARY_NN_UDS,
+    LIBRARY_NN_VCTL,
+    LIBRARY_NSYSCCR,
+    LIBRARY_NSYSHID,
+    LIBRARY_NSYSKBD,
+    LIBRARY_NSYSNET,
+    LIBRARY_NSYSUHS,
+    LIBRARY_NSYSUVD,
+    LIBRARY_NTAG,
+    LIBRARY_PADSCORE,
+    LIBRARY_PROC_UI,
+    LIBRARY_SND_CORE,
+    LIBRARY_SND_USER,
+    LIBRARY_SNDCORE2,
+    LIBRARY_SNDUSER2,
+    LIBRARY_SWKBD,
+    LIBRARY_SYSAPP,
+    LIBRARY_TCL,
+    LIBRARY_TVE,
+    LIBRARY_UAC,
+    LIBRARY_UAC_RPL,
+    LIBRARY_USB_MIC,
+    LIBRARY_UVC,
+    LIBRARY_UVD,
+    LIBRARY_VPAD,
+    LIBRARY_VPADBASE,
+    LIBRARY_ZLIB125,
+    LIBRARY_OTHER,
+} function_replacement_library_type_t;
+
+typedef enum FunctionPatcherTargetProcess {
+    FP_TARGET_PROCESS_ALL = 0xFF,
+    FP_TARGET_PROCESS_ROOT_RPX = 1,
+    FP_TARGET_PROCESS_WII_U_MENU = 2,
+    FP_TARGET_PROCESS_TVII = 3,
+    FP_TARGET_PROCESS_E_MANUAL = 4,
+    FP_TARGET_PROCESS_HOME_MENU = 5,
+    FP_TARGET_PROCESS_ERROR_DISPLAY = 6,
+    FP_TARGET_PROCESS_MINI_MIIVERSE = 7,
+    FP_TARGET_PROCESS_BROWSER = 8,
+    FP_TARGET_PROCESS_MIIVERSE = 9,
+    FP_TARGET_PROCESS_ESHOP = 10,
+    FP_TARGET_PROCESS_PFID_11 = 11,
+    FP_TARGET_PROCESS_DOWNLOAD_MANAGER = 12,
+    FP_TARGET_PROCESS_PFID_13 = 13,
+    FP_TARGET_PROCESS_PFID_14 = 14,
+    FP_TARGET_PROCESS_GAME = 15,
+    FP_TARGET_PROCESS_GAME_AND_MENU = 16,
+} FunctionPatcherTargetProcess;
+
+typedef enum FunctionPatcherFunctionType {
+    FUNCTION_PATCHER_REPLACE_BY_LIB_OR_ADDRESS = 0,
+    FUNCTION_PATCHER_REPLACE_FOR_EXECUTABLE_BY_ADDRESS = 1,
+} FunctionPatcherFunctionType;
+
+/**
+ * Cut down from libfunctionpatcher - only what the mocks and Inkay look at. replaceAddr/replaceCall are real host
+ * pointers; the binary is linked below 4 GiB (see mock/cafe.h) so they survive being stored as uint32_t.
+ */
+typedef struct function_replacement_data_t {
+    FunctionPatcherFunctionType type;
+    uint32_t physicalAddr;
+    uint32_t virtualAddr;
+    uint32_t replaceAddr;
+    uint32_t *replaceCall;
+    FunctionPatcherTargetProcess targetProcess;
+
+    // FUNCTION_PATCHER_REPLACE_BY_LIB_OR_ADDRESS
+    function_replacement_library_type_t library;
+    const char *function_name;
+
+    // FUNCTION_PATCHER_REPLACE_FOR_EXECUTABLE_BY_ADDRESS
+    const uint64_t *title_ids;
+    uint32_t title_id_count;
+    const char *executable_name;
+    uint32_t text_offset;
+    uint16_t version_min;
+    uint16_t version_max;
+} function_replacement_data_t;
+
+// the real_ pointer is filled in on install, with whatever mock_fp_original() registered under the function's name
+#define DECL_FUNCTION(res, name, ...)                                  \
+    res (*real_##name)(__VA_ARGS__) __attribute__((section(".data"))); \
+    res my_##name(__VA_ARGS__)
+
+#define REPLACE_FUNCTION(x, lib, name) REPLACE_FUNCTION_FOR_PROCESS(x, lib, name, FP_TARGET_PROCESS_GAME_AND_MENU)
+
+#define REPLACE_FUNCTION_FOR_PROCESS(x, lib, name, process)                                                              \
+    function_replacement_data_t {                                                                               \
+        .type = FUNCTION_PATCHER_REPLACE_BY_LIB_OR_ADDRESS, .physicalAddr = 0, .virtualAddr = 0,                \
+        .replaceAddr = (uint32_t) (uintptr_t) my_##x, .replaceCall = (uint32_t *) &(real_##x),                  \
+        .targetProcess = process, .library = lib, .function_name = #name, .title_ids = nullptr,        \
+        .title_id_count = 0, .executable_name = nullptr, .text_offset = 0, .version_min = 0, .version_max = 0 \
+    }
+
+#define REPLACE_FUNCTION_OF_EXECUTABLE_BY_ADDRESS_WITH_VERSION(x, tids, tid_count, exe, offset, vmin, vmax)        \
+    function_replacement_data_t {                                                                                  \
+        .type = FUNCTION_PATCHER_REPLACE_FOR_EXECUTABLE_BY_ADDRESS, .physicalAddr = 0, .virtualAddr = 0,           \
+        .replaceAddr = (uint32_t) (uintptr_t) my_##x, .replaceCall = (uint32_t *) &(real_##x),                     \
+        .targetProcess = FP_TARGET_PROCESS_GAME, .library = LIBRARY_OTHER, .function_name = #x, .title_ids = tids, \
+        .title_id_count = (uint32_t) (tid_count), .executable_name = exe, .text_offset = offset,                   \
+        .version_min = vmin, .version_max = vmax                                                                   \
+    }
+
+FunctionPatcherStatus FunctionPatcher_InitLibrary();
+FunctionPatcherStatus FunctionPatcher_DeInitLibrary();
+FunctionPatcherStatus FunctionPatcher_AddFunctionPatch(function_replacement_data_t *function_data,
+                                                       PatchedFunctionHandle *outHandle, bool *outHasBeenPatched);
+FunctionPatcherStatus FunctionPatcher_RemoveFunctionPatch(PatchedFunctionHandle handle);
@@ -0,0 +1,37 @@
+/*  Copyright 2026 Pretendo Network contributors <pretendo.network>
+
+    Permission to use, copy, modify, and/or distribute this software for any purpose with or without fee is hereby
+    granted, provided that the above copyright notice and this permission notice appear in all copies.
+
+    THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES WITH REGARD TO THIS SOFTWARE INCLUDING ALL
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT,
+    INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER
+    IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR
+    PERFORMANCE OF THIS SOFTWARE.
+*/
+
+#pragma once
+
+#include <cstdint>
+
+typedef enum MochaUtilsStatus {
+    MOCHA_RESULT_SUCCESS = 0,
+    MOCHA_RESULT_INVALID_ARGUMENT = -0x01,
+    MOCHA_RESULT_MAX_CLIENT = -0x02,
+    MOCHA_RESULT_OUT_OF_MEMORY = -0x03,
+    MOCHA_RESULT_ALREADY_EXISTS = -0x04,
+    MOCHA_RESULT_ADD_DEVOPTAB_FAILED = -0x05,
+    MOCHA_RESULT_NOT_FOUND = -0x06,
+    MOCHA_RESULT_UNSUPPORTED_API_VERSION = -0x10,
+    MOCHA_RESULT_UNSUPPORTED_COMMAND = -0x11,
+    MOCHA_RESULT_UNSUPPORTED_CFW = -0x12,
+    MOCHA_RESULT_LIB_UNINITIALIZED = -0x20,
+    MOCHA_RESULT_UNKNOWN_ERROR = -0x100,
+} MochaUtilsStatus;
+
+MochaUtilsStatus Mocha_InitLibrary();
+MochaUtilsStatus Mocha_DeInitLibrary();
+
+// IOSU memory is a sparse word map, see mock_iosu_read()
+MochaUtilsStatus Mocha_IOSUKernelRead32(uint32_t address, uint32_t *out_buffer);
+MochaUtilsStatus Mocha_IOSUKernelWrite32(uint32_t address, uint32_t value);
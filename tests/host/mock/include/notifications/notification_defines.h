@@ -0,0 +1,44 @@
+/*  Copyright 2026 Pretendo Network contributors <pretendo.network>
+
+    Permission to use, copy, modify, and/or distribute this software for any purpose with or without fee is hereby
+    granted, provided that the above copyright notice and this permission notice appear in all copies.
+
+    THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES WITH REGARD TO THIS SOFTWARE INCLUDING ALL
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT,
+    INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER
+    IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR
+    PERFORMANCE OF THIS SOFTWARE.
+*/
+
+#pragma once
+
+#include <cstdint>
+
+typedef enum NotificationModuleStatus {
+    NOTIFICATION_MODULE_RESULT_SUCCESS = 0,
+    NOTIFICATION_MODULE_RESULT_MODULE_NOT_FOUND = -0x1,
+    NOTIFICATION_MODULE_RESULT_MODULE_MISSING_EXPORT = -0x2,
+    NOTIFICATION_MODULE_RESULT_UNSUPPORTED_VERSION = -0x3,
+    NOTIFICATION_MODULE_RESULT_INVALID_ARGUMENT = -0x10,
+    NOTIFICATION_MODULE_RESULT_ALLOCATION_FAILED = -0x11,
+    NOTIFICATION_MODULE_RESULT_OVERLAY_NOT_READY = -0x12,
+    NOTIFICATION_MODULE_RESULT_UNSUPPORTED_TYPE = -0x13,
+    NOTIFICATION_MODULE_RESULT_LIB_UNINITIALIZED = -0x20,
+    NOTIFICATION_MODULE_RESULT_UNKNOWN_ERROR = -0x100,
+} NotificationModuleStatus;
+
+typedef enum NotificationModuleNotificationType {
+    NOTIFICATION_MODULE_NOTIFICATION_TYPE_INFO = 0,
+    NOTIFICATION_MODULE_NOTIFICATION_TYPE_ERROR = 1,
+    NOTIFICATION_MODULE_NOTIFICATION_TYPE_DYNAMIC = 2,
+} NotificationModuleNotificationType;
+
+typedef enum NotificationModuleNotificationOption {
+    NOTIFICATION_MODULE_DEFAULT_OPTION_BACKGROUND_COLOR = 0,
+    NOTIFICATION_MODULE_DEFAULT_OPTION_TEXT_COLOR = 1,
+    NOTIFICATION_MODULE_DEFAULT_OPTION_DURATION_BEFORE_FADE_OUT = 2,
+    NOTIFICATION_MODULE_DEFAULT_OPTION_FADE_OUT_TIME = 3,
+    NOTIFICATION_MODULE_DEFAULT_OPTION_NOTIFICATION_FINISHED_FUNCTION = 4,
+    NOTIFICATION_MODULE_DEFAULT_OPTION_NOTIFICATION_FINISHED_FUNCTION_CONTEXT = 5,
+    NOTIFICATION_MODULE_DEFAULT_OPTION_KEEP_UNTIL_SHOWN = 6,
+} NotificationModuleNotificationOption;
@@ -0,0 +1,40 @@
+/*  Copyright 2026 Pretendo Network contributors <pretendo.network>
+
+    Permission to use, copy, modify, and/or distribute this software for any purpose with or without fee is hereby
+    granted, provided that the above copyright notice and this permission notice appear in all copies.
+
+    THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES WITH REGARD TO THIS SOFTWARE INCLUDING ALL
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT,
+    INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER
+    IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR
+    PERFORMANCE OF THIS SOFTWARE.
+*/
+
+#pragma once
+
+/**
+ * The module's lifecycle hooks become plain functions the harness calls (see mock/cafe.h), and exports go into
+ * a table mock_wums_export() looks names up in.
+ */
+#define WUMS_MODULE_EXPORT_NAME(x)
+#define WUMS_MODULE_DESCRIPTION(x)
+#define WUMS_MODULE_VERSION(x)
+#define WUMS_MODULE_AUTHOR(x)
+#define WUMS_MODULE_LICENSE(x)
+#define WUMS_DEPENDS_ON(x)
+#define WUMS_USE_WUT_DEVOPTAB()
+
+#define WUMS_INITIALIZE() void wums_initialize()
+#define WUMS_DEINITIALIZE() void wums_deinitialize()
+#define WUMS_APPLICATION_STARTS() void wums_application_starts()
+#define WUMS_ALL_APPLICATION_STARTS_DONE() void wums_all_application_starts_done()
+#define WUMS_APPLICATION_ENDS() void wums_application_ends()
+
+void mock_wums_add_export(const char *name, void *address);
+
+struct mock_wums_export_entry {
+    mock_wums_export_entry(const char *name, void *address) { mock_wums_add_export(name, address); }
+};
+
+#define WUMS_EXPORT_FUNCTION(function) \
+    static mock_wums_export_entry wums_export_##function(#function, (void *) &function)
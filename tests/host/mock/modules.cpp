@@ -0,0 +1,162 @@
+/*  Copyright 2026 Pretendo Network contributors <pretendo.network>
+
+    Permission to use, copy, modify, and/or distribute this software for any purpose with or without fee is hereby
+    granted, provided that the above copyright notice and this permission notice appear in all copies.
+
+    THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES WITH REGARD TO THIS SOFTWARE INCLUDING ALL
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT,
+    INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER
+    IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR
+    PERFORMANCE OF THIS SOFTWARE.
+*/
+
+#include "cafe.h"
+
+#include <function_patcher/function_patching.h>
+#include <notifications/notifications.h>
+#include <wums.h>
+
+#include <cstdarg>
+#include <cstdio>
+#include <cstring>
+#include <mutex>
+#include <string>
+#include <vector>
+
+struct mock_original {
+    const char *function_name;
+    void *original;
+};
+
+struct mock_patch {
+    function_replacement_data_t data;
+    bool installed;
+};
+
+struct mock_export {
+    const char *name;
+    void *address;
+};
+
+static std::vector<mock_original> originals;
+static std::vector<mock_patch> patches;
+static bool patcher_ready = false;
+
+static std::mutex notification_mutex;
+static std::vector<std::string> notifications;
+
+static std::vector<mock_export> &exports() {
+    // filled in by static initialisers, so it can't be a plain global
+    static std::vector<mock_export> table;
+    return table;
+}
+
+void mock_wums_add_export(const char *name, void *address) {
+    exports().push_back({name, address});
+}
+
+void *mock_wums_export(const char *name) {
+    for (const auto &entry: exports()) {
+        if (strcmp(entry.name, name) == 0) return entry.address;
+    }
+    return nullptr;
+}
+
+void mock_fp_original(const char *function_name, void *original) {
+    for (auto &entry: originals) {
+        if (strcmp(entry.function_name, function_name) == 0) {
+            entry.original = original;
+            return;
+        }
+    }
+    originals.push_back({function_name, original});
+}
+
+void *mock_fp_hook(const char *function_name, FunctionPatcherTargetProcess process) {
+    for (const auto &patch: patches) {
+        if (patch.installed && patch.data.targetProcess == process &&
+            strcmp(patch.data.function_name, function_name) == 0) {
+            return (void *) (uintptr_t) patch.data.replaceAddr;
+        }
+    }
+    return nullptr;
+}
+
+uint32_t mock_fp_installed() {
+    uint32_t count = 0;
+    for (const auto &patch: patches) {
+        count += patch.installed;
+    }
+    return count;
+}
+
+FunctionPatcherStatus FunctionPatcher_InitLibrary() {
+    patcher_ready = true;
+    return FUNCTION_PATCHER_RESULT_SUCCESS;
+}
+
+FunctionPatcherStatus FunctionPatcher_DeInitLibrary() {
+    patcher_ready = false;
+    return FUNCTION_PATCHER_RESULT_SUCCESS;
+}
+
+FunctionPatcherStatus FunctionPatcher_AddFunctionPatch(function_replacement_data_t *function_data,
+                                                       PatchedFunctionHandle *outHandle, bool *outHasBeenPatched) {
+    if (!patcher_ready) return FUNCTION_PATCHER_RESULT_LIB_UNINITIALIZED;
+    if (!function_data || !function_data->replaceAddr || !function_data->replaceCall) {
+        return FUNCTION_PATCHER_RESULT_INVALID_ARGUMENT;
+    }
+
+    void *original = nullptr;
+    for (const auto &entry: originals) {
+        if (strcmp(entry.function_name, function_data->function_name) == 0) original = entry.original;
+    }
+    if (!original) {
+        fprintf(stderr, "mock: no original for %s, register one with mock_fp_original\n", function_data->function_name);
+        return FUNCTION_PATCHER_RESULT_MODULE_NOT_FOUND;
+    }
+
+    // replaceCall is really the hook's real_ function pointer
+    *(void **) function_data->replaceCall = original;
+    patches.push_back({*function_data, true});
+    if (outHandle) *outHandle = patches.size();
+    if (outHasBeenPatched) *outHasBeenPatched = true;
+    return FUNCTION_PATCHER_RESULT_SUCCESS;
+}
+
+FunctionPatcherStatus FunctionPatcher_RemoveFunctionPatch(PatchedFunctionHandle handle) {
+    if (handle == 0 || handle > patches.size() || !patches[handle - 1].installed) {
+        return FUNCTION_PATCHER_RESULT_PATCH_NOT_FOUND;
+    }
+    patches[handle - 1].installed = false;
+    return FUNCTION_PATCHER_RESULT_SUCCESS;
+}
+
+uint32_t mock_notification_count() {
+    std::lock_guard lock(notification_mutex);
+    return notifications.size();
+}
+
+const char *mock_notification(uint32_t index) {
+    std::lock_guard lock(notification_mutex);
+    return index < notifications.size() ? notifications[index].c_str() : nullptr;
+}
+
+NotificationModuleStatus NotificationModule_InitLibrary() {
+    return NOTIFICATION_MODULE_RESULT_SUCCESS;
+}
+
+NotificationModuleStatus NotificationModule_DeInitLibrary() {
+    return NOTIFICATION_MODULE_RESULT_SUCCESS;
+}
+
+NotificationModuleStatus NotificationModule_SetDefaultValue(NotificationModuleNotificationType type,
+                                                            NotificationModuleNotificationOption optionType, ...) {
+    return NOTIFICATION_MODULE_RESULT_SUCCESS;
+}
+
+NotificationModuleStatus NotificationModule_AddInfoNotification(const char *text) {
+    std::lock_guard lock(notification_mutex);
+    notifications.emplace_back(text);
+    return NOTIFICATION_MODULE_RESULT_SUCCESS;
+}
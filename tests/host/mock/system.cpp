@@ -0,0 +1,247 @@
+/*  Copyright 2026 Pretendo Network contributors <pretendo.network>
+
+    Permission to use, copy, modify, and/or distribute this software for any purpose with or without fee is hereby
+    granted, provided that the above copyright notice and this permission notice appear in all copies.
+
+    THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES WITH REGARD TO THIS SOFTWARE INCLUDING ALL
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT,
+    INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER
+    IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR
+    PERFORMANCE OF THIS SOFTWARE.
+*/
+
+#include "cafe.h"
+
+#include <coreinit/dynload.h>
+#include <coreinit/mcp.h>
+#include <coreinit/title.h>
+#include <coreinit/userconfig.h>
+#include <mocha/mocha.h>
+
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+#include <mutex>
+#include <optional>
+#include <unordered_map>
+#include <vector>
+
+#define MOCK_MAX_NOTIFY_CALLBACKS 8
+
+struct mock_notify_callback {
+    OSDynLoadNotifyFunc fn;
+    void *context;
+};
+
+static uint64_t title_id = 0;
+static std::optional<uint16_t> title_version;
+static std::atomic<uint32_t> mcp_calls = 0;
+
+static char console_serial[12] = "FW400000000";
+static MCPSystemVersion console_version = {5, 5, 6, 'E'};
+static uint32_t console_language = 1;
+
+static std::vector<OSDynLoad_NotifyData> rpls;
+static mock_notify_callback notify_callbacks[MOCK_MAX_NOTIFY_CALLBACKS];
+static uint32_t notify_callback_count = 0;
+
+static std::mutex iosu_mutex;
+static std::unordered_map<uint32_t, uint32_t> iosu_memory;
+static uint32_t iosu_writes = 0;
+static std::optional<uint32_t> iosu_failing_address;
+
+void mock_set_title(uint64_t id, std::optional<uint16_t> version) {
+    title_id = id;
+    title_version = version;
+}
+
+void mock_set_console(const char *serial, MCPSystemVersion os_version, uint32_t language) {
+    snprintf(console_serial, sizeof(console_serial), "%s", serial);
+    console_version = os_version;
+    console_language = language;
+}
+
+uint32_t mock_mcp_calls() {
+    return mcp_calls;
+}
+
+uint64_t OSGetTitleID() {
+    return title_id;
+}
+
+int32_t MCP_Open() {
+    mcp_calls++;
+    return 1;
+}
+
+int32_t MCP_Close(int32_t handle) {
+    mcp_calls++;
+    return 0;
+}
+
+// the title is its own update, so asking for either gets the version
+int32_t MCP_GetTitleInfo(int32_t handle, uint64_t id, MCPTitleListType *titleInfo) {
+    mcp_calls++;
+    if ((id & ~0x0000000E00000000ull) != (title_id & ~0x0000000E00000000ull) || !title_version) return -1;
+
+    *titleInfo = {};
+    titleInfo->titleId = id;
+    titleInfo->titleVersion = *title_version;
+    return 0;
+}
+
+int32_t MCP_GetSysProdSettings(int32_t handle, MCPSysProdSettings *settings) {
+    mcp_calls++;
+    *settings = {};
+    settings->product_area = MCP_REGION_EUROPE;
+    settings->game_region = MCP_REGION_EUROPE;
+    snprintf(settings->code_id, sizeof(settings->code_id), "%.2s", console_serial);
+    snprintf(settings->serial_id, sizeof(settings->serial_id), "%s", console_serial + 2);
+    return 0;
+}
+
+int32_t MCP_GetSystemVersion(int32_t handle, MCPSystemVersion *version) {
+    mcp_calls++;
+    *version = console_version;
+    return 0;
+}
+
+UCHandle UCOpen() {
+    return 1;
+}
+
+void UCClose(UCHandle handle) {
+}
+
+UCError UCReadSysConfig(UCHandle handle, uint32_t count, UCSysConfig *settings) {
+    for (uint32_t i = 0; i < count; i++) {
+        if (strcmp(settings[i].name, "cafe.language") != 0 || settings[i].dataSize != sizeof(uint32_t)) {
+            settings[i].error = UC_ERROR_ERROR;
+            return UC_ERROR_ERROR;
+        }
+        memcpy(settings[i].data, &console_language, sizeof(console_language));
+    }
+    return UC_ERROR_OK;
+}
+
+// names are never freed - Inkay keeps pointers to them in its index, like it would to the loader's
+static OSDynLoad_NotifyData copy_rpl(const OSDynLoad_NotifyData &data) {
+    auto rpl = data;
+    rpl.name = strdup(data.name ? data.name : "");
+    return rpl;
+}
+
+void mock_rpl_reset(const OSDynLoad_NotifyData *loaded, size_t count) {
+    rpls.clear();
+    for (size_t i = 0; i < count; i++) {
+        rpls.push_back(copy_rpl(loaded[i]));
+    }
+}
+
+static void notify(OSDynLoad_NotifyData *rpl, OSDynLoad_NotifyReason reason) {
+    // a copy, callbacks may remove themselves
+    mock_notify_callback callbacks[MOCK_MAX_NOTIFY_CALLBACKS];
+    const uint32_t count = notify_callback_count;
+    memcpy(callbacks, notify_callbacks, sizeof(callbacks));
+
+    for (uint32_t i = 0; i < count; i++) {
+        callbacks[i].fn(nullptr, callbacks[i].context, reason, rpl);
+    }
+}
+
+void mock_rpl_load(const OSDynLoad_NotifyData &data) {
+    rpls.push_back(copy_rpl(data));
+    auto rpl = rpls.back();
+    notify(&rpl, OS_DYNLOAD_NOTIFY_LOADED);
+}
+
+void mock_rpl_unload(const char *name) {
+    for (size_t i = 0; i < rpls.size(); i++) {
+        if (strcmp(rpls[i].name, name) != 0) continue;
+
+        auto rpl = rpls[i];
+        rpls.erase(rpls.begin() + i);
+        notify(&rpl, OS_DYNLOAD_NOTIFY_UNLOADED);
+        return;
+    }
+}
+
+int32_t OSDynLoad_GetNumberOfRPLs() {
+    return (int32_t) rpls.size();
+}
+
+bool OSDynLoad_GetRPLInfo(uint32_t first, uint32_t count, OSDynLoad_NotifyData *outInfos) {
+    if ((uint64_t) first + count > rpls.size()) return false;
+
+    for (uint32_t i = 0; i < count; i++) {
+        outInfos[i] = rpls[first + i];
+    }
+    return true;
+}
+
+OSDynLoad_Error OSDynLoad_AddNotifyCallback(OSDynLoadNotifyFunc notifyFn, void *userContext) {
+    if (!notifyFn || notify_callback_count == MOCK_MAX_NOTIFY_CALLBACKS) return OS_DYNLOAD_INVALID_NOTIFY_PTR;
+
+    notify_callbacks[notify_callback_count++] = {notifyFn, userContext};
+    return OS_DYNLOAD_OK;
+}
+
+void OSDynLoad_DelNotifyCallback(OSDynLoadNotifyFunc notifyFn, void *userContext) {
+    for (uint32_t i = 0; i < notify_callback_count; i++) {
+        if (notify_callbacks[i].fn == notifyFn && notify_callbacks[i].context == userContext) {
+            notify_callbacks[i] = notify_callbacks[--notify_callback_count];
+            return;
+        }
+    }
+}
+
+uint32_t mock_iosu_read(uint32_t address) {
+    std::lock_guard lock(iosu_mutex);
+    const auto it = iosu_memory.find(address);
+    return it == iosu_memory.end() ? 0 : it->second;
+}
+
+uint32_t mock_iosu_writes() {
+    std::lock_guard lock(iosu_mutex);
+    return iosu_writes;
+}
+
+void mock_iosu_fail_access(uint32_t address) {
+    std::lock_guard lock(iosu_mutex);
+    iosu_failing_address = address;
+}
+
+// true once for the address mock_iosu_fail_access() was given, iosu_mutex held
+static bool iosu_access_fails(uint32_t address) {
+    if (iosu_failing_address != address) return false;
+    iosu_failing_address.reset();
+    return true;
+}
+
+MochaUtilsStatus Mocha_InitLibrary() {
+    return MOCHA_RESULT_SUCCESS;
+}
+
+MochaUtilsStatus Mocha_DeInitLibrary() {
+    return MOCHA_RESULT_SUCCESS;
+}
+
+MochaUtilsStatus Mocha_IOSUKernelRead32(uint32_t address, uint32_t *out_buffer) {
+    if (address % 4) return MOCHA_RESULT_INVALID_ARGUMENT;
+
+    std::lock_guard lock(iosu_mutex);
+    if (iosu_access_fails(address)) return MOCHA_RESULT_UNKNOWN_ERROR;
+    const auto it = iosu_memory.find(address);
+    *out_buffer = it == iosu_memory.end() ? 0 : it->second;
+    return MOCHA_RESULT_SUCCESS;
+}
+
+MochaUtilsStatus Mocha_IOSUKernelWrite32(uint32_t address, uint32_t value) {
+    if (address % 4) return MOCHA_RESULT_INVALID_ARGUMENT;
+
+    std::lock_guard lock(iosu_mutex);
+    if (iosu_access_fails(address)) return MOCHA_RESULT_UNKNOWN_ERROR;
+    iosu_memory[address] = value;
+    iosu_writes++;
+    return MOCHA_RESULT_SUCCESS;
+}
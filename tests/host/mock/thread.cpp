@@ -0,0 +1,174 @@
+/*  Copyright 2026 Pretendo Network contributors <pretendo.network>
+
+    Permission to use, copy, modify, and/or distribute this software for any purpose with or without fee is hereby
+    granted, provided that the above copyright notice and this permission notice appear in all copies.
+
+    THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES WITH REGARD TO THIS SOFTWARE INCLUDING ALL
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT,
+    INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER
+    IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR
+    PERFORMANCE OF THIS SOFTWARE.
+*/
+
+#include "cafe.h"
+#include "hook_stats.h"
+
+#include <coreinit/mutex.h>
+#include <coreinit/thread.h>
+
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <pthread.h>
+#include <sched.h>
+
+// console threads get a few KiB, glibc wants a lot more than that for printf and friends
+#define MOCK_THREAD_STACK_SIZE 0x100000
+
+static std::atomic<uint32_t> threads_alive = 0;
+static thread_local OSThread *current_thread = nullptr;
+// set while the mocks allocate for themselves, like the TLS pthread_create sets up - not something the console does
+static thread_local bool mock_allocating = false;
+
+uint32_t mock_threads_alive() {
+    return threads_alive;
+}
+
+bool OSCreateThread(OSThread *thread, OSThreadEntryPointFn entry, int32_t argc, char *argv, void *stack,
+                    uint32_t stackSize, int32_t priority, OSThreadAttributes attributes) {
+    // undefined on the console - the old thread's state would be thrown away under it
+    if (thread->resumed && !thread->detached) {
+        fprintf(stderr, "mock: creating a thread over %s, which was never joined\n", thread->name ? thread->name : "?");
+        abort();
+    }
+    *thread = {};
+    thread->entry = entry;
+    thread->argc = argc;
+    thread->argv = (const char **) argv;
+    thread->detached = attributes & OS_THREAD_ATTRIB_DETACHED;
+    return true;
+}
+
+void OSSetThreadName(OSThread *thread, const char *name) {
+    thread->name = name;
+}
+
+OSThread *OSGetCurrentThread() {
+    static thread_local OSThread host_thread;
+    return current_thread ? current_thread : &host_thread;
+}
+
+static void *thread_main(void *arg) {
+    auto *thread = (OSThread *) arg;
+    current_thread = thread;
+    thread->result = thread->entry(thread->argc, thread->argv);
+    threads_alive--;
+    return nullptr;
+}
+
+// only starts the thread - suspending and resuming again isn't something Inkay does
+int32_t OSResumeThread(OSThread *thread) {
+    if (thread->resumed) return 0;
+    thread->resumed = true;
+    threads_alive++;
+
+    // the stack is never freed - the mocks only start a handful of threads per run
+    pthread_attr_t attr;
+    pthread_attr_init(&attr);
+    pthread_attr_setstack(&attr, mock_low_stack(MOCK_THREAD_STACK_SIZE), MOCK_THREAD_STACK_SIZE);
+    if (thread->detached) pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_DETACHED);
+
+    mock_allocating = true;
+    if (pthread_create(&thread->thread, &attr, thread_main, thread) != 0) {
+        fprintf(stderr, "mock: couldn't start thread %s\n", thread->name ? thread->name : "?");
+        abort();
+    }
+    mock_allocating = false;
+    pthread_attr_destroy(&attr);
+    return 1;
+}
+
+bool OSJoinThread(OSThread *thread, int *threadResult) {
+    // the real one would wait forever
+    if (!thread->resumed || thread->detached) {
+        fprintf(stderr, "mock: joining thread %s, which can never finish\n", thread->name ? thread->name : "?");
+        abort();
+    }
+
+    pthread_join(thread->thread, nullptr);
+    thread->resumed = false;
+    if (threadResult) *threadResult = thread->result;
+    return true;
+}
+
+void OSDetachThread(OSThread *thread) {
+    thread->detached = true;
+    if (thread->resumed) pthread_detach(thread->thread);
+}
+
+void OSSleepTicks(OSTime ticks) {
+    const uint64_t ns = (uint64_t) ticks * 1000000000ull / OSTimerClockSpeed;
+    const timespec ts = {(time_t) (ns / 1000000000ull), (long) (ns % 1000000000ull)};
+    nanosleep(&ts, nullptr);
+}
+
+void OSYieldThread() {
+    sched_yield();
+}
+
+void OSInitMutex(OSMutex *mutex) {
+    pthread_mutexattr_t attr;
+    pthread_mutexattr_init(&attr);
+    pthread_mutexattr_settype(&attr, PTHREAD_MUTEX_RECURSIVE);
+    pthread_mutex_init(&mutex->mutex, &attr);
+    pthread_mutexattr_destroy(&attr);
+    mutex->initialized = true;
+}
+
+static void check_mutex(OSMutex *mutex) {
+    if (!mutex->initialized) {
+        fprintf(stderr, "mock: OSMutex used before OSInitMutex\n");
+        abort();
+    }
+}
+
+void OSLockMutex(OSMutex *mutex) {
+    check_mutex(mutex);
+    pthread_mutex_lock(&mutex->mutex);
+}
+
+void OSUnlockMutex(OSMutex *mutex) {
+    check_mutex(mutex);
+    pthread_mutex_unlock(&mutex->mutex);
+}
+
+bool OSTryLockMutex(OSMutex *mutex) {
+    check_mutex(mutex);
+    return pthread_mutex_trylock(&mutex->mutex) == 0;
+}
+
+#ifdef HOOK_STATS
+// the harness links HOOK_STATS builds with --wrap for these, since nothing the host allocates goes near
+// MEMAllocFromDefaultHeap. new and glibc's own allocations end up here as well
+extern "C" {
+void *__real_malloc(size_t size);
+void *__real_calloc(size_t count, size_t size);
+void *__real_realloc(void *ptr, size_t size);
+
+void *__wrap_malloc(size_t size) {
+    if (!mock_allocating) hook_stats_note_alloc();
+    return __real_malloc(size);
+}
+
+void *__wrap_calloc(size_t count, size_t size) {
+    if (!mock_allocating) hook_stats_note_alloc();
+    return __real_calloc(count, size);
+}
+
+void *__wrap_realloc(void *ptr, size_t size) {
+    if (!mock_allocating) hook_stats_note_alloc();
+    return __real_realloc(ptr, size);
+}
+}
+#endif
@@ -0,0 +1,388 @@
+/*  Copyright 2026 Pretendo Network contributors <pretendo.network>
+
+    Permission to use, copy, modify, and/or distribute this software for any purpose with or without fee is hereby
+    granted, provided that the above copyright notice and this permission notice appear in all copies.
+
+    THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES WITH REGARD TO THIS SOFTWARE INCLUDING ALL
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT,
+    INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER
+    IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR
+    PERFORMANCE OF THIS SOFTWARE.
+*/
+
+/**
+ * Host benchmark for the memory scan engine (ScanQueue, replaceBulk). Builds console-sized images at MEM2's address,
+ * plants Inkay's real needles at fixed offsets, and times each scan against scan_bench_baseline.txt - a different
+ * match count or a throughput drop beyond the tolerance fails the run.
+ *
+ *   scan_bench [--baseline FILE] [--update] [--tolerance 0.5] [--reps 5] [--image dump.bin@0x10000000]...
+ *
+ * Throughput is the image size over the best rep's time, so a scan that finishes early scores higher. The default
+ * tolerance is loose because host timings are noisy - it's there to catch a lost fast path, not a few percent.
+ *
+ * Recorded images (raw memory dumps) are scanned with the same cases; they're only checked against the baseline if it
+ * has an entry for them, since they aren't checked in.
+ */
+
+#include "cafe.h"
+#include "olv_urls.h"
+#include "patch_txn.h"
+#include "replace_mem.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <span>
+#include <string>
+#include <sys/stat.h>
+
+// MEM2, where the applets and nn_olv keep everything we look for
+#define IMAGE_BASE 0x10000000u
+#define IMAGE_PAGE 0x20000u
+
+#define MAX_RESULTS 64
+#define MAX_IMAGES 4
+
+// copies of the needles in olv_applet.cpp, eshop_applet.cpp and account_settings.cpp - the hook harness patches the
+// real ones, so these can't drift without that failing too
+struct applet_allowlist {
+    char scheme[16];
+    char domain[128];
+    char path[128];
+    unsigned char flags[5];
+};
+
+struct account_settings_allowlist {
+    char scheme[16];
+    char domain[128];
+    char path[128];
+    uint32_t flags;
+};
+
+static constexpr applet_allowlist olv_allowlist = {"https", ".nintendo.net", "", {1, 1, 1, 1, 1}};
+static constexpr applet_allowlist eshop_allowlist = {"https", "samurai.wup.shop.nintendo.net", "", {1, 1, 1, 1, 0}};
+static constexpr account_settings_allowlist account_allowlist = {"https", "account.nintendo.net", "", 0x01010101};
+static constexpr char eshop_url[] = "https://ninja.wup.shop.nintendo.net/ninja/wood_index.html?";
+
+static const uint8_t miiverse_green_highlight[] = {
+        0x82, 0xff, 0x05, 0xff, 0x82, 0xff, 0x05, 0xff, 0x1d, 0xff, 0x04, 0xff, 0x1d, 0xff, 0x04, 0xff
+};
+static const uint8_t juxt_purple_highlight[] = {
+        0x5d, 0x4a, 0x9a, 0xff, 0x5d, 0x4a, 0x9a, 0xff, 0x5d, 0x4a, 0x9a, 0xff, 0x5d, 0x4a, 0x9a, 0xff
+};
+static const uint8_t miiverse_green_touch1[] = {0x94, 0xd9, 0x2a, 0x00, 0x57, 0xbd, 0x12, 0xff};
+static const uint8_t juxt_purple_touch1[] = {0x5d, 0x4a, 0x9a, 0x00, 0x5d, 0x4a, 0x9a, 0xff};
+static const uint8_t miiverse_green_touch2[] = {0x57, 0xbd, 0x12, 0x00, 0x94, 0xd9, 0x2a, 0xff};
+static const uint8_t juxt_purple_touch2[] = {0x5d, 0x4a, 0x9a, 0x00, 0x5d, 0x4a, 0x9a, 0xff};
+
+static const replacement juxt_replacements[] = {
+        {miiverse_green_highlight, juxt_purple_highlight},
+        {miiverse_green_touch1,    juxt_purple_touch1},
+        {miiverse_green_touch2,    juxt_purple_touch2},
+};
+
+#define JUXT_COPIES 8
+
+struct image {
+    char name[64];
+    uint32_t size;
+    bool synthetic;
+};
+
+struct result {
+    char name[96];
+    double gbps;
+    uint32_t matches;
+};
+
+struct baseline_entry {
+    char name[96];
+    double gbps;
+    uint32_t matches;
+};
+
+static result results[MAX_RESULTS];
+static uint32_t result_count = 0;
+static baseline_entry baseline[MAX_RESULTS];
+static uint32_t baseline_count = 0;
+
+static uint32_t reps = 5;
+
+static std::span<const uint8_t> bytes_of(const void *data, size_t size) {
+    return {(const uint8_t *) data, size};
+}
+
+// where each needle goes, as a fraction of the image - spread out so First requests end at different points
+static uint32_t needle_addr(const image &img, double where) {
+    return IMAGE_BASE + ((uint32_t) (img.size * where) & ~0xfu) + 0x124;
+}
+
+static void plant(uint32_t addr, std::span<const uint8_t> needle) {
+    memcpy((void *) (uintptr_t) addr, needle.data(), needle.size());
+}
+
+static void plant_needles(const image &img) {
+    if (!img.synthetic) return;
+
+    plant(needle_addr(img, 0.82), bytes_of(original_url, sizeof(original_url)));
+    plant(needle_addr(img, 0.61), bytes_of(&olv_allowlist, sizeof(olv_allowlist)));
+    plant(needle_addr(img, 0.45), bytes_of(eshop_url, sizeof(eshop_url)));
+    plant(needle_addr(img, 0.47), bytes_of(&eshop_allowlist, sizeof(eshop_allowlist)));
+    plant(needle_addr(img, 0.93), bytes_of(&account_allowlist, sizeof(account_allowlist)));
+    // theme colours end up all over the applet's heap
+    for (int i = 0; i < JUXT_COPIES; i++) {
+        const double where = 0.03 + 0.1 * i;
+        for (int j = 0; j < (int) std::size(juxt_replacements); j++) {
+            plant(needle_addr(img, where + 0.004 * j), juxt_replacements[j].orig);
+        }
+    }
+}
+
+/**
+ * Roughly what MEM2 looks like to a scan: mostly populated pages, every fourth one zeroed (freshly allocated heap),
+ * and an unmapped hole an eighth of the way from the end. plant_needles() keeps clear of the hole.
+ */
+static void build_synthetic(image &img, uint32_t size) {
+    snprintf(img.name, sizeof(img.name), "synthetic_%um", size >> 20);
+    img.size = size;
+    img.synthetic = true;
+
+    mock_map(IMAGE_BASE, size);
+    uint64_t state = 0x9e3779b97f4a7c15ull ^ size;
+    for (uint32_t page = 0; page < size / IMAGE_PAGE; page++) {
+        if (page % 4 == 3) continue;
+
+        auto *words = (uint64_t *) (uintptr_t) (IMAGE_BASE + page * IMAGE_PAGE);
+        for (uint32_t i = 0; i < IMAGE_PAGE / sizeof(uint64_t); i++) {
+            // xorshift64
+            state ^= state << 13;
+            state ^= state >> 7;
+            state ^= state << 17;
+            words[i] = state;
+        }
+    }
+
+    const uint32_t hole = (size - size / 8) & ~(IMAGE_PAGE - 1);
+    mock_unmap(IMAGE_BASE + hole, size / 32);
+    plant_needles(img);
+}
+
+static bool load_recorded(image &img, const char *arg) {
+    char path[256];
+    snprintf(path, sizeof(path), "%s", arg);
+    uint32_t addr = IMAGE_BASE;
+    if (char *at = strrchr(path, '@')) {
+        *at = '\0';
+        addr = strtoul(at + 1, nullptr, 16);
+    }
+
+    struct stat st;
+    if (stat(path, &st) != 0 || addr != IMAGE_BASE || st.st_size == 0 || st.st_size > 0x10000000) {
+        fprintf(stderr, "scan_bench: %s must be a dump of at most 256 MiB taken at %08x\n", path, IMAGE_BASE);
+        return false;
+    }
+
+    const char *base = strrchr(path, '/');
+    snprintf(img.name, sizeof(img.name), "%.63s", base ? base + 1 : path);
+    img.size = (st.st_size + IMAGE_PAGE - 1) & ~(IMAGE_PAGE - 1);
+    img.synthetic = false;
+
+    mock_map(IMAGE_BASE, img.size);
+    FILE *file = fopen(path, "rb");
+    const bool ok = file && fread((void *) (uintptr_t) IMAGE_BASE, 1, st.st_size, file) == (size_t) st.st_size;
+    if (file) fclose(file);
+    return ok;
+}
+
+static void release_image(const image &img) {
+    mock_map(IMAGE_BASE, img.size);
+    mock_clear(IMAGE_BASE, img.size);
+}
+
+// best of reps, so a hiccup on the host doesn't count as a regression
+template <typename F>
+static void run_case(const image &img, const char *what, F &&scan) {
+    double best = 1e30;
+    uint32_t matches = 0;
+    for (uint32_t rep = 0; rep < reps; rep++) {
+        plant_needles(img);
+        const auto start = std::chrono::steady_clock::now();
+        matches = scan();
+        const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        best = std::min(best, elapsed.count());
+    }
+
+    auto &r = results[result_count++];
+    snprintf(r.name, sizeof(r.name), "%s:%s", img.name, what);
+    r.gbps = img.size / best / 1e9;
+    r.matches = matches;
+    printf("%-40s %8.2f GB/s %6u matches\n", r.name, r.gbps, (unsigned) r.matches);
+}
+
+static void run_image(const image &img) {
+    const uint32_t size = img.size;
+
+    // Miiverse URL with a dry-run transaction, as the title patches do
+    run_case(img, "olv_url", [&] {
+        PatchTransaction txn;
+        ScanQueue queue(&txn);
+        const auto url = queue.add(original_url, sizeof(original_url), new_url, sizeof(new_url));
+        queue.run(IMAGE_BASE, size);
+        return queue.matches(url);
+    });
+
+    // Inkay_BenchmarkScan: the same needle, but nothing stops the sweep early
+    run_case(img, "olv_url_all", [&] {
+        PatchTransaction txn;
+        ScanQueue queue(&txn);
+        const auto url = queue.add(original_url, sizeof(original_url), new_url, sizeof(new_url), match_policy::All);
+        queue.run(IMAGE_BASE, size);
+        return queue.matches(url);
+    });
+
+    // everything the applet hooks look for, in one queue
+    run_case(img, "applet_queue", [&] {
+        PatchTransaction txn;
+        ScanQueue queue(&txn);
+        queue.add(original_url, sizeof(original_url), new_url, sizeof(new_url));
+        queue.add(&olv_allowlist, sizeof(olv_allowlist), &olv_allowlist, sizeof(olv_allowlist));
+        queue.add(eshop_url, sizeof(eshop_url), eshop_url, sizeof(eshop_url));
+        queue.add(&eshop_allowlist, sizeof(eshop_allowlist), &eshop_allowlist, sizeof(eshop_allowlist));
+        queue.add(&account_allowlist, sizeof(account_allowlist), &account_allowlist, sizeof(account_allowlist));
+        queue.run(IMAGE_BASE, size);
+
+        uint32_t total = 0;
+        for (size_t i = 0; i < queue.size(); i++) total += queue.matches(i);
+        return total;
+    });
+
+    // the Juxt recolor writes for real, the needles get planted again before every rep
+    run_case(img, "juxt_recolor", [&] {
+        return (uint32_t) replaceBulk(IMAGE_BASE, size, juxt_replacements);
+    });
+}
+
+static bool load_baseline(const char *path) {
+    FILE *file = fopen(path, "r");
+    if (!file) return false;
+
+    char line[256];
+    while (fgets(line, sizeof(line), file) && baseline_count < MAX_RESULTS) {
+        if (line[0] == '#' || line[0] == '\n') continue;
+
+        auto &entry = baseline[baseline_count];
+        unsigned matches;
+        if (sscanf(line, "%95s %lf %u", entry.name, &entry.gbps, &matches) == 3) {
+            entry.matches = matches;
+            baseline_count++;
+        }
+    }
+    fclose(file);
+    return true;
+}
+
+static bool save_baseline(const char *path) {
+    FILE *file = fopen(path, "w");
+    if (!file) return false;
+
+    fprintf(file, "# scan_bench baseline - regenerate with make -C tests/host bench-baseline\n");
+    fprintf(file, "# case GB/s matches\n");
+    for (uint32_t i = 0; i < result_count; i++) {
+        fprintf(file, "%s %.2f %u\n", results[i].name, results[i].gbps, (unsigned) results[i].matches);
+    }
+    fclose(file);
+    return true;
+}
+
+static const baseline_entry *find_baseline(const char *name) {
+    for (uint32_t i = 0; i < baseline_count; i++) {
+        if (strcmp(baseline[i].name, name) == 0) return &baseline[i];
+    }
+    return nullptr;
+}
+
+static int compare(double tolerance) {
+    int failures = 0;
+    for (uint32_t i = 0; i < result_count; i++) {
+        const auto &r = results[i];
+        const auto *expected = find_baseline(r.name);
+        if (!expected) {
+            printf("NEW  %s isn't in the baseline\n", r.name);
+            continue;
+        }
+
+        if (r.matches != expected->matches) {
+            printf("FAIL %s: %u matches, baseline has %u\n", r.name, (unsigned) r.matches,
+                   (unsigned) expected->matches);
+            failures++;
+        }
+        if (r.gbps < expected->gbps * (1.0 - tolerance)) {
+            printf("FAIL %s: %.2f GB/s, more than %.0f%% below the baseline's %.2f\n", r.name, r.gbps,
+                   tolerance * 100, expected->gbps);
+            failures++;
+        }
+    }
+    return failures;
+}
+
+static int bench_main(int argc, char **argv) {
+    const char *baseline_path = "scan_bench_baseline.txt";
+    bool update = false;
+    double tolerance = 0.5;
+    const char *recorded[MAX_IMAGES];
+    int recorded_count = 0;
+
+    for (int i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "--baseline") && i + 1 < argc) {
+            baseline_path = argv[++i];
+        } else if (!strcmp(argv[i], "--update")) {
+            update = true;
+        } else if (!strcmp(argv[i], "--tolerance") && i + 1 < argc) {
+            tolerance = atof(argv[++i]);
+        } else if (!strcmp(argv[i], "--reps") && i + 1 < argc) {
+            reps = std::max(1, atoi(argv[++i]));
+        } else if (!strcmp(argv[i], "--image") && i + 1 < argc && recorded_count < MAX_IMAGES) {
+            recorded[recorded_count++] = argv[++i];
+        } else {
+            fprintf(stderr, "scan_bench: unknown argument %s\n", argv[i]);
+            return 2;
+        }
+    }
+
+    for (uint32_t size: {32u << 20, 256u << 20}) {
+        image img;
+        build_synthetic(img, size);
+        run_image(img);
+        release_image(img);
+    }
+    for (int i = 0; i < recorded_count; i++) {
+        image img;
+        if (!load_recorded(img, recorded[i])) return 2;
+        run_image(img);
+        release_image(img);
+    }
+
+    if (update) {
+        if (!save_baseline(baseline_path)) {
+            fprintf(stderr, "scan_bench: couldn't write %s\n", baseline_path);
+            return 2;
+        }
+        printf("baseline written to %s\n", baseline_path);
+        return 0;
+    }
+
+    if (!load_baseline(baseline_path)) {
+        fprintf(stderr, "scan_bench: no baseline at %s\n", baseline_path);
+        return 2;
+    }
+    const int failures = compare(tolerance);
+    printf("%s\n", failures ? "scan_bench: FAILED" : "scan_bench: ok");
+    return failures ? 1 : 0;
+}
+
+int main(int argc, char **argv) {
+    return mock_run(bench_main, argc, argv);
+}
@@ -0,0 +1,59 @@
+#!/usr/bin/env python3
+"""Decodes the binary trace a TRACE=1 build of Inkay writes to wiiu/inkay_trace/trace.bin on the SD card. Older records
+are in trace.old.bin, which decodes the same way.
+
+Event names come from the trace_event enum in src/utils/trace.h, so new events don't need changes here.
+
+usage: decode_trace.py trace.bin [path/to/trace.h]
+"""
+
+import re
+import struct
+import sys
+from pathlib import Path
+
+MAGIC = 0x494B5452
+RECORD = struct.Struct(">IHHII")  # tick, event, core, a, b - big-endian, as the console wrote it
+TICKS_PER_US = 62.15
+
+
+def enum_names(header, enum):
+    body = re.search(r"enum " + enum + r"\b[^{]*\{(.*?)\};", header, re.S).group(1)
+    return [m.group(1) for m in re.finditer(r"^\s*(\w+)\s*,", body, re.M)]
+
+
+def main():
+    trace_path = Path(sys.argv[1])
+    header_path = Path(sys.argv[2]) if len(sys.argv) > 2 else Path(__file__).parent.parent / "src/utils/trace.h"
+
+    header = header_path.read_text()
+    events = enum_names(header, "trace_event")
+    hooks = enum_names(header, "trace_hook")
+
+    data = trace_path.read_bytes()
+    if len(data) < 4 or struct.unpack_from(">I", data)[0] != MAGIC:
+        sys.exit(f"{trace_path}: not an Inkay trace")
+
+    last_tick = {}
+    for offset in range(4, len(data) - RECORD.size + 1, RECORD.size):
+        tick, event, core, a, b = RECORD.unpack_from(data, offset)
+        name = events[event] if event < len(events) else f"EVENT_{event}"
+
+        # ticks wrap every ~69s, so show the gap to the previous record on the same core instead
+        delta = (tick - last_tick.get(core, tick)) & 0xFFFFFFFF
+        last_tick[core] = tick
+
+        if name == "TRACE_CA_REPLACED":
+            args = f"{hooks[a] if a < len(hooks) else a} size={b}"
+        elif name == "TRACE_SCAN_MATCH":
+            args = f"needle={a} @{b:08x}"
+        elif name == "TRACE_IDBE_HIT":
+            args = f"title=...{a:08X} v{b}"
+        else:
+            args = f"a={a:#x} b={b:#x}"
+
+        print(f"core{core} +{delta / TICKS_PER_US:10.1f}us {name:<22} {args}")
+
+
+if __name__ == "__main__":
+    main()